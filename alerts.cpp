@@ -0,0 +1,246 @@
+#include "alerts.h"
+
+#include <EEPROM.h>
+
+#include "assets.h"
+#include "profile.h"
+
+// Regra pronta para avaliar: bordas de entrada e saída já calculadas
+struct CompiledRule {
+  int16_t onLow;        // abaixo: entra em alerta
+  int16_t onHigh;       // acima: entra em alerta
+  int16_t offLow;       // entre offLow e offHigh: volta ao normal
+  int16_t offHigh;
+  uint8_t channel;
+  uint8_t debounce;
+  uint8_t pending;      // avaliações seguidas pedindo a troca de estado
+  bool    active;
+};
+
+static AlertRule    rules[ALERT_MAX_RULES];
+static CompiledRule compiled[ALERT_MAX_RULES];
+static uint8_t      ruleCount = 0;
+
+static uint8_t  buzzer     = 0;
+static uint8_t  activeMask = 0;      // canais em alerta
+static uint8_t  ledsOn     = 0;      // regras com o LED aceso (bit por regra)
+static uint16_t toneHz     = 0;      // tom atual do buzzer (0 = mudo)
+
+// As bordas de saída não podem se cruzar: com low + hysteresis acima
+// de high - hysteresis nenhum valor devolveria a regra ao normal
+static bool ruleValid(const AlertRule& rule) {
+  return rule.low < rule.high &&
+         (int32_t)rule.low + rule.hysteresis <= (int32_t)rule.high - rule.hysteresis;
+}
+
+static void compileRule(uint8_t index) {
+  const AlertRule& rule = rules[index];
+  CompiledRule&    c    = compiled[index];
+
+  c.onLow    = rule.low;
+  c.onHigh   = rule.high;
+  c.offLow   = rule.low + rule.hysteresis;
+  c.offHigh  = rule.high - rule.hysteresis;
+  c.channel  = rule.channel < ALERT_CHANNELS ? rule.channel : ALERT_CH_TEMP;
+  c.debounce = rule.debounce ? rule.debounce : 1;
+  c.pending  = 0;
+  c.active   = false;
+}
+
+/************************************************************
+ *                  BLOCO DE CONFIGURAÇÃO                   *
+ ************************************************************/
+static void packRule(const AlertRule& rule, uint8_t* out) {
+  out[0] = rule.channel;
+  out[1] = (uint8_t)rule.low;
+  out[2] = (uint8_t)((uint16_t)rule.low >> 8);
+  out[3] = (uint8_t)rule.high;
+  out[4] = (uint8_t)((uint16_t)rule.high >> 8);
+  out[5] = rule.hysteresis;
+  out[6] = rule.debounce;
+  out[7] = rule.led;
+  out[8] = rule.priority;
+}
+
+static void unpackRule(const uint8_t* in, AlertRule& rule) {
+  rule.channel    = in[0];
+  rule.low        = (int16_t)(in[1] | (in[2] << 8));
+  rule.high       = (int16_t)(in[3] | (in[4] << 8));
+  rule.hysteresis = in[5];
+  rule.debounce   = in[6];
+  rule.led        = in[7];
+  rule.priority   = in[8];
+}
+
+bool alertLoad() {
+  int     address = ALERT_CONFIG_ADDRESS;
+  uint8_t count   = EEPROM.read(address + 1);
+  if (EEPROM.read(address) != ALERT_CONFIG_MAGIC || count == 0 || count > ALERT_MAX_RULES) {
+    return false;
+  }
+
+  int     len = 2 + count * ALERT_RULE_BYTES;
+  uint8_t crc = 0xFF;
+  for (int i = 0; i < len; i++) crc = crc8(crc, EEPROM.read(address + i));
+  if (crc != EEPROM.read(address + len)) return false;
+
+  uint8_t   packed[ALERT_RULE_BYTES];
+  AlertRule loaded[ALERT_MAX_RULES];
+  for (uint8_t r = 0; r < count; r++) {
+    for (uint8_t i = 0; i < ALERT_RULE_BYTES; i++) {
+      packed[i] = EEPROM.read(address + 2 + r * ALERT_RULE_BYTES + i);
+    }
+    unpackRule(packed, loaded[r]);
+    if (!ruleValid(loaded[r])) return false;
+  }
+  for (uint8_t r = 0; r < count; r++) {
+    rules[r] = loaded[r];
+    compileRule(r);
+  }
+  ruleCount = count;
+  return true;
+}
+
+// Byte 'index' do bloco, sem o CRC final
+static uint8_t configByte(uint8_t index) {
+  if (index == 0) return ALERT_CONFIG_MAGIC;
+  if (index == 1) return ruleCount;
+  uint8_t packed[ALERT_RULE_BYTES];
+  index -= 2;
+  packRule(rules[index / ALERT_RULE_BYTES], packed);
+  return packed[index % ALERT_RULE_BYTES];
+}
+
+static uint8_t saveNext = 0xFF;      // próximo byte a gravar (0xFF = parado)
+static uint8_t saveCrc  = 0xFF;
+
+void alertSaveBegin() {
+  saveNext = 0;
+  saveCrc  = 0xFF;
+}
+
+bool alertSaveStep() {
+  uint8_t len = 2 + ruleCount * ALERT_RULE_BYTES;
+  while (saveNext <= len) {
+    int     address = ALERT_CONFIG_ADDRESS + saveNext;
+    uint8_t value   = saveNext < len ? configByte(saveNext) : saveCrc;
+    if (saveNext < len) saveCrc = crc8(saveCrc, value);
+    saveNext++;
+
+    if (EEPROM.read(address) == value) continue;
+    profileEepromUpdate(address, value);
+    return saveNext <= len;
+  }
+  saveNext = 0xFF;
+  return false;
+}
+
+void alertSave() {
+  alertSaveBegin();
+  while (alertSaveStep()) {}
+}
+
+/************************************************************
+ *                        TABELA                            *
+ ************************************************************/
+void alertBegin(uint8_t buzzerPin, const AlertRule* defaults, uint8_t count) {
+  buzzer     = buzzerPin;
+  activeMask = 0;
+  ledsOn     = 0;
+  toneHz     = 0;
+
+  if (alertLoad()) return;
+
+  if (count > ALERT_MAX_RULES) count = ALERT_MAX_RULES;
+  for (uint8_t r = 0; r < count; r++) {
+    rules[r] = assetRead(&defaults[r]);
+    compileRule(r);
+  }
+  ruleCount = count;
+}
+
+uint8_t alertRuleCount() {
+  return ruleCount;
+}
+
+const AlertRule& alertRule(uint8_t index) {
+  return rules[index];
+}
+
+bool alertSetRule(uint8_t index, const AlertRule& rule) {
+  if (index > ruleCount || index >= ALERT_MAX_RULES || !ruleValid(rule)) return false;
+  if (index == ruleCount) ruleCount++;
+  rules[index] = rule;
+  compileRule(index);
+  return true;
+}
+
+/************************************************************
+ *                       AVALIAÇÃO                          *
+ ************************************************************/
+uint8_t alertEvaluate(const int16_t values[ALERT_CHANNELS], uint8_t freshMask) {
+  uint8_t mask = 0;
+
+  for (uint8_t r = 0; r < ruleCount; r++) {
+    CompiledRule& c = compiled[r];
+
+    if (freshMask & (1 << c.channel)) {
+      int16_t value = values[c.channel];
+      bool    flip  = c.active ? (value >= c.offLow && value <= c.offHigh)
+                               : (value < c.onLow || value > c.onHigh);
+      if (!flip) {
+        c.pending = 0;
+      }
+      else if (++c.pending >= c.debounce) {
+        c.active  = !c.active;
+        c.pending = 0;
+      }
+    }
+
+    if (c.active) mask |= 1 << c.channel;
+  }
+
+  activeMask = mask;
+  return mask;
+}
+
+void alertOutputs(bool enabled) {
+  uint8_t leds = 0;
+  uint8_t top  = 0;
+
+  if (enabled) {
+    for (uint8_t r = 0; r < ruleCount; r++) {
+      if (!compiled[r].active) continue;
+      leds |= 1 << r;
+      if (rules[r].priority > top) top = rules[r].priority;
+    }
+  }
+
+  // Só os LEDs das regras que mudaram; um LED compartilhado fica
+  // aceso enquanto qualquer regra dele estiver ativa
+  uint8_t changed = leds ^ ledsOn;
+  for (uint8_t r = 0; changed && r < ruleCount; r++) {
+    if (!(changed & (1 << r))) continue;
+    bool lit = false;
+    for (uint8_t o = 0; o < ruleCount; o++) {
+      if ((leds & (1 << o)) && rules[o].led == rules[r].led) lit = true;
+    }
+    digitalWrite(rules[r].led, lit ? HIGH : LOW);
+  }
+  ledsOn = leds;
+
+  uint16_t hz = top ? ALERT_TONE_HZ(top) : 0;
+  if (hz != toneHz) {
+    if (hz) tone(buzzer, hz);
+    else    noTone(buzzer);
+    toneHz = hz;
+  }
+}
+
+uint8_t alertActive() {
+  return activeMask;
+}
+
+bool alertBuzzerOn() {
+  return toneHz != 0;
+}
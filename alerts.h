@@ -0,0 +1,90 @@
+/************************************************************
+ *          REGRAS DE ALERTA (LED/BUZZER) EM TABELA         *
+ ************************************************************/
+// Cada regra vigia um canal (temperatura, umidade ou luminosidade)
+// e entra em alerta quando o valor sai de [low, high]. Para sair do
+// alerta o valor precisa voltar para dentro de
+// [low + hysteresis, high - hysteresis], e qualquer mudança de estado
+// só vale depois de 'debounce' leituras novas seguidas pedindo a mesma
+// coisa. Assim um valor parado em cima do limite não fica ligando e
+// desligando LED e buzzer. Regras em que essa faixa de saída fica
+// vazia são recusadas.
+//
+// Os limites ficam nas unidades internas do firmware (centésimos de
+// °C, centésimos de %, % de luz), independentes da escala exibida.
+// Ao carregar a tabela, as bordas de entrada e saída de cada regra
+// são calculadas uma vez; alertEvaluate() só compara inteiros.
+//
+// O buzzer toca enquanto houver regra ativa com prioridade > 0, no
+// tom da maior prioridade ativa. LEDs e buzzer só mudam quando o
+// estado muda, não a cada avaliação.
+//
+// A tabela pode ser gravada num bloco de configuração na EEPROM,
+// logo depois da região do log:
+//
+//   [ALERT_CONFIG_MAGIC][n][n regras de ALERT_RULE_BYTES][crc8]
+//
+// Sem um bloco válido, valem as regras padrão do firmware.
+#ifndef ALERTS_H
+#define ALERTS_H
+
+#include <Arduino.h>
+
+#include "logstore.h"
+
+// Canais avaliados (o bit 1 << canal é o TELEMETRY_ALERT_* do canal)
+#define ALERT_CH_TEMP         0
+#define ALERT_CH_HUMD         1
+#define ALERT_CH_LIGHT        2
+#define ALERT_CHANNELS        3
+#define ALERT_ALL             ((1 << ALERT_CHANNELS) - 1)
+
+#define ALERT_MAX_RULES       3
+#define ALERT_RULE_BYTES      9
+#define ALERT_CONFIG_ADDRESS  992    // últimos 32 bytes da EEPROM, depois dos episódios
+#define ALERT_CONFIG_SIZE     (3 + ALERT_MAX_RULES * ALERT_RULE_BYTES)
+#define ALERT_CONFIG_MAGIC    0xA1
+
+// Tom do buzzer por prioridade (1 = 1000 Hz, como antes)
+#define ALERT_TONE_HZ(priority)  (500 + 500 * (priority))
+
+struct AlertRule {
+  uint8_t channel;      // ALERT_CH_*
+  int16_t low;          // alerta abaixo deste valor
+  int16_t high;         // alerta acima deste valor
+  uint8_t hysteresis;   // margem para voltar ao normal
+  uint8_t debounce;     // leituras novas seguidas para mudar de estado (>= 1)
+  uint8_t led;          // pino do LED da regra
+  uint8_t priority;     // prioridade no buzzer (0 = não toca)
+};
+
+// Carrega as regras da EEPROM ou, se não houver bloco válido, usa
+// 'defaults' (em PROGMEM). 'buzzerPin' é o pino usado por tone().
+void    alertBegin(uint8_t buzzerPin, const AlertRule* defaults, uint8_t count);
+bool    alertLoad();
+void    alertSave();
+// Gravação em partes: cada alertSaveStep() grava no máximo um byte
+// que mudou (~3,3 ms na EEPROM interna); devolve false no fim
+void    alertSaveBegin();
+bool    alertSaveStep();
+
+uint8_t          alertRuleCount();
+const AlertRule& alertRule(uint8_t index);
+// false (e nada muda) se a posição não existe ou a regra é inválida:
+// low >= high, ou low + hysteresis > high - hysteresis
+bool             alertSetRule(uint8_t index, const AlertRule& rule);
+
+// Avalia todas as regras de uma vez. 'values' é indexado por canal;
+// só os canais em 'freshMask' têm leitura nova e são avaliados (o
+// debounce conta leituras, não chamadas); os demais mantêm o estado.
+// Devolve os canais em alerta (bit 1 << canal).
+uint8_t alertEvaluate(const int16_t values[ALERT_CHANNELS], uint8_t freshMask);
+
+// Aplica o estado aos LEDs e ao buzzer; com 'enabled' falso, tudo
+// fica desligado mas as regras continuam sendo avaliadas
+void    alertOutputs(bool enabled);
+
+uint8_t alertActive();      // canais em alerta (bit 1 << canal)
+bool    alertBuzzerOn();
+
+#endif
@@ -0,0 +1,322 @@
+#include "archive.h"
+
+#include <EEPROM.h>
+
+#include "profile.h"
+
+#define CH_TEMP  0
+#define CH_HUMD  1
+#define CH_LUM   2
+
+// Período em curso de um anel, nas unidades de entrada
+struct Accum {
+  uint32_t period;
+  int32_t  sum[ARCHIVE_CHANNELS];
+  uint16_t weight;         // amostras (minuto) ou minutos (hora, dia)
+  uint8_t  cover;          // períodos menores somados
+  int16_t  min[ARCHIVE_CHANNELS];
+  int16_t  max[ARCHIVE_CHANNELS];
+};
+
+static const uint32_t periods[ARCHIVE_TIERS] PROGMEM = { 60UL, 3600UL, 86400UL };
+
+static bool     external = false;
+static uint16_t base[ARCHIVE_TIERS];
+static uint8_t  slots[ARCHIVE_TIERS];
+static Accum    accums[ARCHIVE_TIERS];
+static uint32_t lastNow = 0;
+
+// Página da AT24C32 em que caem os próximos minutos, montada em RAM:
+// vai ao chip (só os bytes alterados, [pageLo, pageHi)) quando o
+// anel passa para a página seguinte, e não a cada minuto
+static uint8_t  page[AT24_PAGE_SIZE];
+static uint16_t pageAddress = 0xFFFF;     // nenhuma
+static uint8_t  pageLo      = AT24_PAGE_SIZE;
+static uint8_t  pageHi      = 0;
+
+static uint32_t periodOf(uint8_t tier) {
+  return pgm_read_dword(&periods[tier]);
+}
+
+static uint8_t recordSize(uint8_t tier) {
+  return tier == ARCHIVE_MINUTE ? ARCHIVE_MINUTE_SIZE : ARCHIVE_ROLLUP_SIZE;
+}
+
+static uint16_t slotAddress(uint8_t tier, uint32_t period) {
+  return base[tier] + (uint16_t)(period % slots[tier]) * recordSize(tier);
+}
+
+/************************************************************
+ *                     ARMAZENAMENTO                        *
+ ************************************************************/
+static void readBytes(uint16_t address, uint8_t* out, uint8_t len) {
+  if (external) {
+    if (!at24Read(address, out, len)) memset(out, LOG_ERASED, len);
+    // Os minutos ainda na RAM valem mais que o chip
+    for (uint8_t i = 0; i < len; i++) {
+      long offset = (long)address + i - pageAddress;
+      if (offset >= pageLo && offset < pageHi) out[i] = page[offset];
+    }
+    return;
+  }
+  for (uint8_t i = 0; i < len; i++) out[i] = EEPROM.read(address + i);
+}
+
+static void writeBytes(uint16_t address, const uint8_t* data, uint8_t len) {
+  if (external) {
+    at24Write(address, data, len);
+    return;
+  }
+  for (uint8_t i = 0; i < len; i++) profileEepromUpdate(address + i, data[i]);
+}
+
+static void flushPage() {
+  if (pageHi > pageLo) at24Write(pageAddress + pageLo, page + pageLo, pageHi - pageLo);
+  pageLo = AT24_PAGE_SIZE;
+  pageHi = 0;
+}
+
+// Um registro de minuto (só na AT24C32): entra na página da RAM; um
+// registro que cruza o fim da página leva a anterior ao chip
+static void stageBytes(uint16_t address, const uint8_t* data, uint8_t len) {
+  for (uint8_t i = 0; i < len; i++, address++) {
+    uint16_t start = address & ~(uint16_t)(AT24_PAGE_SIZE - 1);
+    if (start != pageAddress) {
+      flushPage();
+      pageAddress = start;
+      if (!at24Read(start, page, AT24_PAGE_SIZE)) memset(page, LOG_ERASED, AT24_PAGE_SIZE);
+    }
+    uint8_t pos = (uint8_t)(address - start);
+    page[pos] = data[i];
+    if (pos < pageLo)     pageLo = pos;
+    if (pos + 1 > pageHi) pageHi = pos + 1;
+  }
+}
+
+/************************************************************
+ *                      CODIFICAÇÃO                         *
+ ************************************************************/
+static int32_t roundDiv(int32_t value, int32_t divisor) {
+  return value >= 0 ? (value + divisor / 2) / divisor : -((-value + divisor / 2) / divisor);
+}
+
+static int32_t clampRange(int32_t value, int32_t lo, int32_t hi) {
+  return value < lo ? lo : (value > hi ? hi : value);
+}
+
+// Centésimos -> meio grau / meio por cento; luminosidade já em %
+static uint8_t encodeValue(uint8_t ch, int16_t value) {
+  if (ch == CH_LUM)  return (uint8_t)clampRange(value, 0, 255);
+  int32_t half = roundDiv(value, 50);
+  if (ch == CH_TEMP) return (uint8_t)(int8_t)clampRange(half, -128, 127);
+  return (uint8_t)clampRange(half, 0, 255);
+}
+
+static int16_t decodeValue(uint8_t ch, uint8_t raw) {
+  if (ch == CH_LUM)  return raw;
+  if (ch == CH_TEMP) return (int16_t)((int8_t)raw * 50);
+  return (int16_t)(raw * 50);
+}
+
+static int16_t accumMean(const Accum& a, uint8_t ch) {
+  return (int16_t)roundDiv(a.sum[ch], a.weight);
+}
+
+static void store(uint8_t tier, const Accum& a) {
+  if (slots[tier] == 0) return;
+
+  uint8_t raw[ARCHIVE_ROLLUP_SIZE];
+  uint8_t n = 0;
+  raw[n++] = (uint8_t)a.period;
+  raw[n++] = (uint8_t)(a.period >> 8);
+  if (tier == ARCHIVE_MINUTE) {
+    for (uint8_t ch = 0; ch < ARCHIVE_CHANNELS; ch++) raw[n++] = encodeValue(ch, accumMean(a, ch));
+  }
+  else {
+    raw[n++] = a.cover;
+    for (uint8_t ch = 0; ch < ARCHIVE_CHANNELS; ch++) {
+      raw[n++] = encodeValue(ch, a.min[ch]);
+      raw[n++] = encodeValue(ch, accumMean(a, ch));
+      raw[n++] = encodeValue(ch, a.max[ch]);
+    }
+  }
+  raw[n] = crc8Buffer(raw, n);
+  if (tier == ARCHIVE_MINUTE) stageBytes(slotAddress(tier, a.period), raw, n + 1);
+  else                        writeBytes(slotAddress(tier, a.period), raw, n + 1);
+}
+
+// Registro do período 'period', se a posição dele ainda o guarda
+static bool load(uint8_t tier, uint32_t period, ArchiveRecord& out) {
+  if (slots[tier] == 0) return false;
+
+  uint8_t raw[ARCHIVE_ROLLUP_SIZE];
+  uint8_t size = recordSize(tier);
+  readBytes(slotAddress(tier, period), raw, size);
+  if (crc8Buffer(raw, size - 1) != raw[size - 1] ||
+      (uint16_t)(raw[0] | (raw[1] << 8)) != (uint16_t)period) return false;
+
+  out.start = period * periodOf(tier);
+  out.tier  = tier;
+  out.open  = false;
+  if (tier == ARCHIVE_MINUTE) {
+    out.cover = 0;
+    for (uint8_t ch = 0; ch < ARCHIVE_CHANNELS; ch++) {
+      out.mean[ch] = out.min[ch] = out.max[ch] = decodeValue(ch, raw[2 + ch]);
+    }
+  }
+  else {
+    out.cover = raw[2];
+    for (uint8_t ch = 0; ch < ARCHIVE_CHANNELS; ch++) {
+      out.min[ch]  = decodeValue(ch, raw[3 + ch * 3]);
+      out.mean[ch] = decodeValue(ch, raw[4 + ch * 3]);
+      out.max[ch]  = decodeValue(ch, raw[5 + ch * 3]);
+    }
+  }
+  return true;
+}
+
+/************************************************************
+ *                      CONSOLIDAÇÃO                        *
+ ************************************************************/
+static void accumReset(Accum& a, uint32_t period) {
+  a.period = period;
+  a.weight = 0;
+  a.cover  = 0;
+  for (uint8_t ch = 0; ch < ARCHIVE_CHANNELS; ch++) a.sum[ch] = 0;
+}
+
+static void accumFold(Accum& a, const int16_t* mean, const int16_t* mn, const int16_t* mx,
+                      uint16_t weight) {
+  for (uint8_t ch = 0; ch < ARCHIVE_CHANNELS; ch++) {
+    if (a.weight == 0 || mn[ch] < a.min[ch]) a.min[ch] = mn[ch];
+    if (a.weight == 0 || mx[ch] > a.max[ch]) a.max[ch] = mx[ch];
+  }
+  for (uint8_t ch = 0; ch < ARCHIVE_CHANNELS; ch++) a.sum[ch] += (int32_t)mean[ch] * weight;
+  if (a.cover < 0xFF) a.cover++;
+  a.weight += weight;
+}
+
+// Grava o período fechado e o soma ao período maior que o contém
+static void closePeriod(uint8_t tier) {
+  Accum& a = accums[tier];
+  store(tier, a);
+
+  if (tier + 1 < ARCHIVE_TIERS) {
+    Accum&   up     = accums[tier + 1];
+    uint32_t parent = a.period * periodOf(tier) / periodOf(tier + 1);
+    if (up.weight > 0 && up.period != parent) closePeriod(tier + 1);
+    if (up.weight == 0) accumReset(up, parent);
+
+    int16_t mean[ARCHIVE_CHANNELS];
+    for (uint8_t ch = 0; ch < ARCHIVE_CHANNELS; ch++) mean[ch] = accumMean(a, ch);
+    // A hora pesa cada minuto igual; o dia, pelos minutos de cada hora
+    accumFold(up, mean, a.min, a.max, tier == ARCHIVE_MINUTE ? 1 : a.weight);
+  }
+  accumReset(a, a.period);
+}
+
+// Refaz o acumulador do período em curso com os menores já gravados
+static void rebuild(uint8_t tier, uint32_t now) {
+  uint8_t  child   = tier - 1;
+  uint32_t current = now / periodOf(tier);
+  uint32_t first   = current * (periodOf(tier) / periodOf(child));
+  uint32_t end     = now / periodOf(child);       // o em curso não foi gravado
+  if (end - first > slots[child]) first = end - slots[child];
+
+  Accum& a = accums[tier];
+  accumReset(a, current);
+  ArchiveRecord r;
+  for (uint32_t p = first; p < end; p++) {
+    if (!load(child, p, r)) continue;
+    accumFold(a, r.mean, r.min, r.max, child == ARCHIVE_MINUTE ? 1 : r.cover);
+  }
+}
+
+void archiveBegin(uint32_t now) {
+  external = logTier() == LOG_TIER_EXTERNAL;
+  slots[ARCHIVE_MINUTE] = external ? ARCHIVE_EXT_MINUTES : ARCHIVE_INT_MINUTES;
+  slots[ARCHIVE_HOUR]   = external ? ARCHIVE_EXT_HOURS   : ARCHIVE_INT_HOURS;
+  slots[ARCHIVE_DAY]    = external ? ARCHIVE_EXT_DAYS    : ARCHIVE_INT_DAYS;
+
+  base[ARCHIVE_MINUTE] = external ? LOG_ARCHIVE_EXT : LOG_ARCHIVE_INT;
+  base[ARCHIVE_HOUR]   = base[ARCHIVE_MINUTE] + slots[ARCHIVE_MINUTE] * ARCHIVE_MINUTE_SIZE;
+  base[ARCHIVE_DAY]    = base[ARCHIVE_HOUR] + slots[ARCHIVE_HOUR] * ARCHIVE_ROLLUP_SIZE;
+
+  lastNow = now;
+  accumReset(accums[ARCHIVE_MINUTE], now / periodOf(ARCHIVE_MINUTE));
+  rebuild(ARCHIVE_HOUR, now);
+  rebuild(ARCHIVE_DAY, now);
+}
+
+void archiveAdd(uint32_t now, const int16_t* values) {
+  lastNow = now;
+
+  // Fecha o que virou, do minuto para o dia: a hora e o dia são
+  // gravados na mesma passada em que o último minuto deles fecha
+  for (uint8_t tier = 0; tier < ARCHIVE_TIERS; tier++) {
+    Accum& a = accums[tier];
+    if (a.weight > 0 && a.period != now / periodOf(tier)) closePeriod(tier);
+  }
+
+  Accum& minute = accums[ARCHIVE_MINUTE];
+  if (minute.weight == 0) accumReset(minute, now / periodOf(ARCHIVE_MINUTE));
+  accumFold(minute, values, values, values, 1);
+}
+
+uint32_t archivePeriod(uint8_t tier) {
+  return periodOf(tier);
+}
+
+uint8_t archiveSlots(uint8_t tier) {
+  return slots[tier];
+}
+
+uint8_t archiveTierFor(uint32_t step) {
+  uint8_t best = ARCHIVE_TIERS;
+  for (uint8_t tier = 0; tier < ARCHIVE_TIERS; tier++) {
+    if (slots[tier] == 0) continue;
+    if (best == ARCHIVE_TIERS || periodOf(tier) <= step) best = tier;
+  }
+  return best == ARCHIVE_TIERS ? ARCHIVE_DAY : best;
+}
+
+/************************************************************
+ *                        CONSULTA                          *
+ ************************************************************/
+ArchiveCursor::ArchiveCursor() : tier(ARCHIVE_MINUTE), index(1), last(0) {}
+
+ArchiveCursor::ArchiveCursor(uint8_t tier, uint32_t from, uint32_t to) : tier(tier) {
+  uint32_t current = lastNow / periodOf(tier);
+
+  // Antes da volta atual do anel não há nada para ler
+  index = from / periodOf(tier);
+  if (index < current && current - index > slots[tier]) index = current - slots[tier];
+  last  = to / periodOf(tier);
+  if (last > current) last = current;
+}
+
+bool ArchiveCursor::next(ArchiveRecord& out) {
+  uint32_t current = lastNow / periodOf(tier);
+  while (index <= last) {
+    uint32_t period = index++;
+    if (period != current) {
+      if (load(tier, period, out)) return true;
+      continue;
+    }
+
+    // Em curso: da RAM, com a precisão de entrada
+    const Accum& a = accums[tier];
+    if (a.weight == 0 || a.period != period) continue;
+    out.start = period * periodOf(tier);
+    out.tier  = tier;
+    out.cover = tier == ARCHIVE_MINUTE ? 0 : a.cover;
+    out.open  = true;
+    for (uint8_t ch = 0; ch < ARCHIVE_CHANNELS; ch++) {
+      out.min[ch]  = a.min[ch];
+      out.mean[ch] = accumMean(a, ch);
+      out.max[ch]  = a.max[ch];
+    }
+    return true;
+  }
+  return false;
+}
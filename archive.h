@@ -0,0 +1,116 @@
+/************************************************************
+ *     ARQUIVO DE TENDÊNCIAS (MINUTO / HORA / DIA, RRD)     *
+ ************************************************************/
+// O log guarda só anomalias; este arquivo guarda a tendência normal
+// dos três canais em anéis de tamanho fixo, um por resolução:
+//
+//   minuto:  média do minuto
+//   hora:    mínimo, média e máximo da hora
+//   dia:     mínimo, média e máximo do dia
+//
+// Cada período tem uma posição fixa no seu anel (período % posições)
+// e o registro guarda os 16 bits baixos do número do período: a
+// leitura confere o número e descarta o que sobrou de voltas antigas
+// ou de intervalos com o aparelho desligado, sem varrer nem guardar
+// cabeça.
+//
+// A consolidação é em cascata e O(1) por amostra: cada amostra entra
+// num acumulador de RAM do minuto; ao virar o minuto, o registro é
+// gravado e o minuto entra no acumulador da hora, que ao virar entra
+// no do dia. No boot, os acumuladores da hora e do dia em curso são
+// refeitos a partir dos minutos e horas já gravados.
+//
+// Registros (temperatura em meio grau e umidade em meio por cento,
+// a resolução do DHT11; luminosidade em %):
+//
+//   minuto: [período u16][temp i8][umid u8][luz u8][crc8]
+//   hora/dia: [período u16][cobertura u8][temp mín/méd/máx i8]
+//             [umid mín/méd/máx u8][luz mín/méd/máx u8][crc8]
+//
+// A cobertura é o número de minutos (hora) ou de horas (dia) que
+// entraram no registro. Os anéis ficam na mesma camada do log
+// (logstore.h): na AT24C32, nas páginas acima dos blocos; sem ela,
+// na EEPROM interna, só horas e dias (um registro por minuto
+// gastaria a EEPROM interna em poucos anos), e um reset perde a hora
+// em curso.
+//
+// Na AT24C32 os minutos são montados numa página em RAM, como o
+// bloco aberto do log, e vão ao chip quando o anel passa para a
+// página seguinte (a cada ~5 minutos): um ciclo de gravação por
+// página, não um por minuto. Um reset perde os minutos da página em
+// RAM, e a hora refeita no boot fica sem eles.
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <Arduino.h>
+
+#include "logstore.h"
+
+#define ARCHIVE_MINUTE       0
+#define ARCHIVE_HOUR         1
+#define ARCHIVE_DAY          2
+#define ARCHIVE_TIERS        3
+
+// Canais, na ordem de ALERT_CH_* (alerts.h)
+#define ARCHIVE_CHANNELS     3
+
+#define ARCHIVE_MINUTE_SIZE  6
+#define ARCHIVE_ROLLUP_SIZE  13
+
+// Posições de cada anel por camada
+#define ARCHIVE_EXT_MINUTES  30     // meia hora
+#define ARCHIVE_EXT_HOURS    48     // dois dias
+#define ARCHIVE_EXT_DAYS     56     // oito semanas
+#define ARCHIVE_INT_MINUTES  0
+#define ARCHIVE_INT_HOURS    9
+#define ARCHIVE_INT_DAYS     10
+
+#if ARCHIVE_EXT_MINUTES * ARCHIVE_MINUTE_SIZE + \
+    (ARCHIVE_EXT_HOURS + ARCHIVE_EXT_DAYS) * ARCHIVE_ROLLUP_SIZE > LOG_ARCHIVE_EXT_SIZE
+#error "arquivo não cabe na AT24C32"
+#endif
+#if ARCHIVE_INT_MINUTES * ARCHIVE_MINUTE_SIZE + \
+    (ARCHIVE_INT_HOURS + ARCHIVE_INT_DAYS) * ARCHIVE_ROLLUP_SIZE > LOG_ARCHIVE_INT_SIZE
+#error "arquivo não cabe na EEPROM interna"
+#endif
+
+// Um período consolidado. Valores nas unidades do resto do firmware:
+// centésimos de °C e de %, e % para a luminosidade.
+struct ArchiveRecord {
+  uint32_t start;                      // hora local do início
+  uint8_t  tier;
+  uint8_t  cover;                      // 0 no minuto
+  bool     open;                       // período em curso (da RAM)
+  int16_t  min[ARCHIVE_CHANNELS];
+  int16_t  mean[ARCHIVE_CHANNELS];
+  int16_t  max[ARCHIVE_CHANNELS];
+};
+
+// Depois de logBegin() (a camada já está escolhida)
+void     archiveBegin(uint32_t now);
+
+// Uma amostra dos três canais (normalmente as médias de 1 s)
+void     archiveAdd(uint32_t now, const int16_t* values);
+
+uint32_t archivePeriod(uint8_t tier);
+uint8_t  archiveSlots(uint8_t tier);
+
+// A resolução mais grossa com período <= 'step' segundos (ou a mais
+// fina que a camada tem, se nenhuma serve)
+uint8_t  archiveTierFor(uint32_t step);
+
+// Períodos de um anel que tocam [from, to], do mais antigo ao
+// mais novo; o período em curso vem por último, da RAM
+class ArchiveCursor {
+public:
+  ArchiveCursor();                   // vazio (para atribuir depois)
+  ArchiveCursor(uint8_t tier, uint32_t from, uint32_t to);
+  bool next(ArchiveRecord& out);
+
+private:
+  uint8_t  tier;
+  uint32_t index;                      // próximo período
+  uint32_t last;                       // último período pedido
+};
+
+#endif
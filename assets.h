@@ -0,0 +1,38 @@
+/************************************************************
+ *             CONSTANTES NA FLASH (PROGMEM)                *
+ ************************************************************/
+// No ATmega328P (2 KB de RAM) tudo o que é constante e não está em
+// PROGMEM é copiado da flash para a RAM no boot: textos, tabelas,
+// desenhos dos glifos. Por isso os textos do firmware saem com F()
+// e as tabelas são declaradas PROGMEM e lidas por aqui:
+//
+//   Serial.println(F("texto"));                 // Print lê da flash
+//   line.text(F("texto"));                      // TextBuffer também
+//   line.text(flashText(tabela[i]));            // char[][N] em PROGMEM
+//   MenuItem item = assetRead(&menuTable[i]);   // struct em PROGMEM
+//
+// Um ponteiro para a flash não pode ser lido direto no AVR (aponta
+// para outro espaço de endereços); no host os dois são a mesma
+// memória (host/avr/pgmspace.h). O relatório de RAM por módulo
+// (tools/ramreport.cmake) mostra o que ainda sobrou na RAM.
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <Arduino.h>
+
+typedef const __FlashStringHelper* FlashText;
+
+// Texto em PROGMEM (PGM_P) com o tipo que Print e TextBuffer aceitam
+inline FlashText flashText(PGM_P text) {
+  return reinterpret_cast<FlashText>(text);
+}
+
+// Cópia em RAM de um valor (struct, inteiro, ponteiro) em PROGMEM
+template <typename T>
+inline T assetRead(const T* source) {
+  T value;
+  memcpy_P(&value, source, sizeof(T));
+  return value;
+}
+
+#endif
@@ -0,0 +1,98 @@
+#include "at24c32.h"
+
+#include <Wire.h>
+
+#include "profile.h"
+
+static bool     present    = false;
+static bool     writing    = false;   // ciclo de escrita em curso
+static uint32_t writeStart = 0;
+
+uint8_t at24Poll() {
+  if (!writing) return AT24_READY;
+  // O chip volta a dar ack no endereço no fim do ciclo de escrita
+  PROFILE_COUNT(PROF_COUNT_I2C, 1);
+  Wire.beginTransmission(AT24_ADDRESS);
+  if (Wire.endTransmission() == 0) {
+    writing = false;
+    return AT24_READY;
+  }
+  if (millis() - writeStart > AT24_WRITE_TIMEOUT_MS) {
+    writing = false;
+    return AT24_FAILED;
+  }
+  return AT24_BUSY;
+}
+
+// Espera o fim do ciclo de escrita (caminho que bloqueia)
+static bool waitReady() {
+  while (true) {
+    uint8_t state = at24Poll();
+    if (state != AT24_BUSY) return state == AT24_READY;
+    delayMicroseconds(AT24_POLL_US);
+  }
+}
+
+static bool setPointer(uint16_t address) {
+  PROFILE_COUNT(PROF_COUNT_I2C, 1);
+  Wire.beginTransmission(AT24_ADDRESS);
+  Wire.write((uint8_t)(address >> 8));
+  Wire.write((uint8_t)address);
+  return Wire.endTransmission() == 0;
+}
+
+bool at24Begin() {
+  Wire.beginTransmission(AT24_ADDRESS);
+  present = Wire.endTransmission() == 0;
+  return present;
+}
+
+bool at24Present() {
+  return present;
+}
+
+bool at24Read(uint16_t address, uint8_t* data, uint16_t len) {
+  if (!present || !waitReady() || !setPointer(address)) return false;
+
+  // Leitura sequencial, limitada pelo buffer da Wire
+  while (len > 0) {
+    uint8_t n = len > BUFFER_LENGTH ? BUFFER_LENGTH : (uint8_t)len;
+    PROFILE_COUNT(PROF_COUNT_I2C, 1);
+    if (Wire.requestFrom((uint8_t)AT24_ADDRESS, n) != n) return false;
+    for (uint8_t i = 0; i < n; i++) *data++ = (uint8_t)Wire.read();
+    len -= n;
+  }
+  return true;
+}
+
+bool at24WriteChunk(uint16_t address, const uint8_t* data, uint8_t len) {
+  if (!present) return false;
+
+  PROFILE_COUNT(PROF_COUNT_I2C, 1);
+  PROFILE_COUNT(PROF_COUNT_AT24, 1);
+  Wire.beginTransmission(AT24_ADDRESS);
+  Wire.write((uint8_t)(address >> 8));
+  Wire.write((uint8_t)address);
+  Wire.write(data, len);
+  if (Wire.endTransmission() != 0) return false;
+  writing    = true;
+  writeStart = millis();
+  return true;
+}
+
+bool at24Write(uint16_t address, const uint8_t* data, uint16_t len) {
+  if (!present || !waitReady()) return false;
+
+  while (len > 0) {
+    // Até o fim do pedaço alinhado atual
+    uint16_t n = AT24_CHUNK - (address % AT24_CHUNK);
+    if (n > len) n = len;
+
+    if (!at24WriteChunk(address, data, (uint8_t)n) || !waitReady()) return false;
+
+    address += n;
+    data    += n;
+    len     -= n;
+  }
+  return true;
+}
@@ -0,0 +1,50 @@
+/************************************************************
+ *        EEPROM EXTERNA AT24C32 DO MÓDULO DO DS3231        *
+ ************************************************************/
+// 4 KB em páginas de 32 bytes, no mesmo barramento I2C do RTC (0x57
+// no módulo ZS-042, com A0-A2 em pull-up). O endereço é de 12 bits,
+// enviado em dois bytes antes dos dados. Uma gravação leva até 5 ms
+// (tWR); nesse tempo o chip não reconhece o endereço, e at24Write()
+// espera por ack polling antes de devolver.
+//
+// Sem espera: at24WriteChunk() envia um pedaço e volta na hora, e
+// at24Poll() sonda o endereço uma vez por chamada até o ciclo de
+// escrita acabar. Quem chama espaça as sondagens (AT24_POLL_MS) entre
+// passadas do agendador. at24Read() espera um ciclo ainda pendente.
+//
+// O buffer da Wire do AVR tem 32 bytes incluindo os 2 do endereço:
+// uma página inteira não cabe numa transmissão, então a escrita é
+// quebrada em pedaços de AT24_CHUNK bytes alinhados, que nunca
+// cruzam o limite de uma página.
+#ifndef AT24C32_H
+#define AT24C32_H
+
+#include <Arduino.h>
+
+#define AT24_ADDRESS           0x57
+#define AT24_SIZE              4096
+#define AT24_PAGE_SIZE         32
+#define AT24_CHUNK             16
+#define AT24_POLL_US           500
+#define AT24_WRITE_TIMEOUT_MS  10
+#define AT24_POLL_MS           1
+
+// Estado do último ciclo de escrita (at24Poll)
+#define AT24_READY             0
+#define AT24_BUSY              1
+#define AT24_FAILED            2      // o chip não voltou em AT24_WRITE_TIMEOUT_MS
+
+// Sonda o endereço; a Wire já deve estar iniciada (rtc.begin())
+bool at24Begin();
+bool at24Present();
+
+// Devolvem false se o chip não respondeu
+bool at24Read(uint16_t address, uint8_t* data, uint16_t len);
+bool at24Write(uint16_t address, const uint8_t* data, uint16_t len);
+
+// Um pedaço de até AT24_CHUNK bytes que não cruza um limite de
+// AT24_CHUNK, sem esperar o ciclo de escrita (ver at24Poll)
+bool    at24WriteChunk(uint16_t address, const uint8_t* data, uint8_t len);
+uint8_t at24Poll();
+
+#endif
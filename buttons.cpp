@@ -0,0 +1,145 @@
+#include "buttons.h"
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#include "power.h"
+#include "ring.h"
+
+// Uma borda: nível de PORTB logo após a mudança e o instante (ms,
+// 16 bits bastam para os intervalos medidos aqui)
+struct ButtonEdge {
+  uint8_t  pins;
+  uint16_t atMs;
+};
+
+struct ButtonState {
+  uint8_t  pin;
+  uint8_t  bit;           // bit em PORTB
+  bool     raw;           // último nível visto (true = pressionado)
+  bool     stable;        // nível depois do debounce
+  bool     longSent;
+  uint32_t changedAt;     // última borda
+  uint32_t nextAt;        // próximo LONG/REPEAT enquanto pressionado
+};
+
+static SpscRing<ButtonEdge, BUTTONS_QUEUE_SIZE> edges;
+static ButtonState   buttons[BUTTONS_MAX];
+static uint8_t       buttonCount = 0;
+static uint8_t       buttonMask  = 0;
+static ButtonHandler onEvent     = NULL;
+static uint8_t       seenDropped = 0;   // edges.dropped() já tratado
+
+// Instante completo de uma marca de 16 bits no passado recente
+static uint32_t expand(uint16_t atMs, uint32_t nowMs) {
+  return nowMs - (uint16_t)((uint16_t)nowMs - atMs);
+}
+
+void buttonsBegin(const uint8_t* pins, uint8_t count, ButtonHandler handler) {
+  if (count > BUTTONS_MAX) count = BUTTONS_MAX;
+  buttonCount = count;
+  onEvent     = handler;
+  buttonMask  = 0;
+  seenDropped = edges.dropped();
+
+  uint32_t nowMs = millis();
+  for (uint8_t i = 0; i < count; i++) {
+    pinMode(pins[i], INPUT_PULLUP);
+    buttons[i].pin       = pins[i];
+    buttons[i].bit       = _BV(pins[i] - 8);
+    buttons[i].raw       = false;
+    buttons[i].stable    = false;
+    buttons[i].longSent  = false;
+    buttons[i].changedAt = nowMs;
+    buttons[i].nextAt    = 0;
+    buttonMask |= buttons[i].bit;
+  }
+
+  cli();
+  PCMSK0 |= buttonMask;
+  PCICR  |= _BV(PCIE0);
+  sei();
+}
+
+bool buttonsPending() {
+  return edges.count() > 0;
+}
+
+uint8_t buttonsDropped() {
+  return edges.dropped();
+}
+
+unsigned long buttonsPoll() {
+  uint32_t nowMs = millis();
+
+  // Bordas novas só atualizam o nível cru e reiniciam o debounce
+  uint8_t    dropped = edges.dropped();
+  ButtonEdge edge;
+  while (edges.pop(edge)) {
+    uint32_t at = expand(edge.atMs, nowMs);
+    for (uint8_t i = 0; i < buttonCount; i++) {
+      bool pressed = !(edge.pins & buttons[i].bit);
+      if (pressed != buttons[i].raw) {
+        buttons[i].raw       = pressed;
+        buttons[i].changedAt = at;
+      }
+    }
+  }
+
+  // Com a fila cheia a ISR perdeu bordas, talvez a última (a que
+  // ficou): o nível cru sai do pino, e o debounce recomeça agora
+  if (dropped != seenDropped) {
+    seenDropped  = dropped;
+    uint8_t pins = PINB;
+    for (uint8_t i = 0; i < buttonCount; i++) {
+      bool pressed = !(pins & buttons[i].bit);
+      if (pressed != buttons[i].raw) {
+        buttons[i].raw       = pressed;
+        buttons[i].changedAt = nowMs;
+      }
+    }
+  }
+
+  unsigned long wait = BUTTONS_IDLE;
+  for (uint8_t i = 0; i < buttonCount; i++) {
+    ButtonState& b = buttons[i];
+
+    if (b.raw != b.stable) {
+      uint32_t settled = nowMs - b.changedAt;
+      if (settled < BUTTON_DEBOUNCE_MS) {
+        if (BUTTON_DEBOUNCE_MS - settled < wait) wait = BUTTON_DEBOUNCE_MS - settled;
+        continue;
+      }
+      b.stable = b.raw;
+      if (b.stable) {
+        b.longSent = false;
+        b.nextAt   = b.changedAt + BUTTON_LONG_MS;
+        onEvent(b.pin, BUTTON_PRESS);
+      }
+      else {
+        onEvent(b.pin, BUTTON_RELEASE);
+      }
+    }
+
+    if (!b.stable) continue;
+
+    // Pressionado: LONG uma vez, depois REPEAT periódico
+    if ((int32_t)(nowMs - b.nextAt) >= 0) {
+      onEvent(b.pin, b.longSent ? BUTTON_REPEAT : BUTTON_LONG);
+      b.longSent = true;
+      b.nextAt  += BUTTON_REPEAT_MS;
+      if ((int32_t)(nowMs - b.nextAt) >= 0) b.nextAt = nowMs + BUTTON_REPEAT_MS;
+    }
+    uint32_t left = b.nextAt - nowMs;
+    if (left < wait) wait = left;
+  }
+  return wait;
+}
+
+ISR(PCINT0_vect) {
+  ButtonEdge edge;
+  edge.pins = PINB;
+  edge.atMs = (uint16_t)millis();
+  edges.push(edge);
+  powerWake();
+}
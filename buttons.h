@@ -0,0 +1,46 @@
+/************************************************************
+ *        BOTÕES POR INTERRUPÇÃO, COM FILA DE EVENTOS       *
+ ************************************************************/
+// Os botões ficam em PORTB (pinos 8..13) com pull-up. A interrupção
+// de mudança de pino PCINT0 grava cada borda, com o instante em ms,
+// numa fila SPSC (ring.h); a ISR não faz mais nada. Fora da ISR,
+// buttonsPoll() consome a fila e transforma as bordas em eventos:
+//
+//   BUTTON_PRESS   -> nível estável em LOW por BUTTON_DEBOUNCE_MS
+//   BUTTON_RELEASE -> nível estável em HIGH de novo
+//   BUTTON_LONG    -> ainda pressionado após BUTTON_LONG_MS
+//   BUTTON_REPEAT  -> depois do LONG, a cada BUTTON_REPEAT_MS
+//
+// buttonsPoll() devolve quantos ms esperar até o próximo prazo (fim
+// de um debounce, long-press ou repetição), ou BUTTONS_IDLE se nada
+// está pendente. Com os botões soltos, nada é lido até a próxima
+// borda: buttonsPending() diz ao loop que chegou alguma. Se a fila
+// encheu (o loop demorou durante um repique), as bordas perdidas
+// podem incluir a última; buttonsPoll() então relê o nível direto
+// de PINB, em vez de confiar no que sobrou na fila.
+#ifndef BUTTONS_H
+#define BUTTONS_H
+
+#include <Arduino.h>
+
+#define BUTTONS_MAX         4
+#define BUTTONS_QUEUE_SIZE  16
+#define BUTTON_DEBOUNCE_MS  30
+#define BUTTON_LONG_MS      800
+#define BUTTON_REPEAT_MS    200
+#define BUTTONS_IDLE        0xFFFFFFFFUL
+
+#define BUTTON_PRESS        0
+#define BUTTON_RELEASE      1
+#define BUTTON_LONG         2
+#define BUTTON_REPEAT       3
+
+typedef void (*ButtonHandler)(uint8_t pin, uint8_t event);
+
+// 'pins' são pinos de PORTB (8..13) com INPUT_PULLUP
+void          buttonsBegin(const uint8_t* pins, uint8_t count, ButtonHandler handler);
+unsigned long buttonsPoll();
+bool          buttonsPending();
+uint8_t       buttonsDropped();   // bordas perdidas com a fila cheia
+
+#endif
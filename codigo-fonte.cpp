@@ -3,35 +3,46 @@
  ************************************************************/
 #include <LiquidCrystal_I2C.h>
 #include <Wire.h>
-#include <DHT.h>
 #include <RTClib.h>
 #include <EEPROM.h>
+#include "scheduler.h"
+#include "logstore.h"
+#include "telemetry.h"
+#include "format.h"
+#include "lcdframe.h"
+#include "glyphs.h"
+#include "stats.h"
+#include "dht11.h"
+#include "ldrsampler.h"
+#include "alerts.h"
+#include "episodes.h"
+#include "timekeeper.h"
+#include "power.h"
+#include "buttons.h"
+#include "logexport.h"
+#include "archive.h"
+#include "profile.h"
+#include "shell.h"
+#include "menu.h"
+#include "assets.h"
+#include "ring.h"
 
 RTC_DS3231 rtc; //OBJETO DO TIPO RTC_DS3231
  
-// COnfigurações dos dias da semana
-char daysOfTheWeek[7][12] = {"Domingo", "Segunda", "Terça", "Quarta", "Quinta", "Sexta", "Sábado"};
-#define UTC_OFFSET -3    // Ajuste de fuso horário para UTC-3
-#define LOG_OPTION 1     // Opção para ativar a leitura do log
-
-// ===============================
-// ALTERADO: Ajustamos recordSize de 8 para 10
-// ===============================
-const int maxRecords     = 100;
-const int recordSize     = 10;  // 4 bytes timestamp + 2 temp + 2 umid + 2 luminosidade
-int       startAddress   = 0;
-int       endAddress     = maxRecords * recordSize;
-int       currentAddress = 0;
-
-int lastLoggedMinute = -1;
-
-// Triggers de temperatura, umidade e luminosidade
-float trigger_t_min = 15.0; 
-float trigger_t_max = 25.0; 
-float trigger_u_min = 30.0; 
-float trigger_u_max = 50.0; 
-float trigger_l_min = 0.0; 
-float trigger_l_max = 30.0; 
+#define UTC_OFFSET -3    // Ajuste de fuso horário para UTC-3 (o DS3231 guarda UTC)
+#define RTC_SQW_PIN 7    // Saída SQW de 1 Hz do DS3231 (PCINT23)
+#define LOG_OPTION 1     // Opção para ativar a exportação do log pela serial (comando "log" e dump)
+
+// Formato da saída serial: texto legível ou quadros binários
+#define SERIAL_TEXT    0
+#define SERIAL_BINARY  1     // COBS + CRC, ver telemetry.h
+#ifndef SERIAL_MODE
+#define SERIAL_MODE    SERIAL_TEXT
+#endif
+int serialMode = SERIAL_MODE;
+#define SERIAL_BAUD    9600
+#define SERIAL_LINE_SIZE 48  // maior linha de texto (buffer na pilha)
+#define SERIAL_OUTPUT_ROOM SHELL_OUTPUT_ROOM   // bytes livres na TX para uma linha ou um quadro
 
 // Endereço e dimensões do LCD I2C
 #define I2C_ADDR     0x27
@@ -39,8 +50,7 @@ float trigger_l_max = 30.0;
 #define LCD_LINES    2
 
 // DHT Sensor
-#define DHTPIN       3       // Pino do DHT
-#define DHTTYPE      DHT11   // Tipo de sensor DHT
+#define DHTPIN       3       // Pino do DHT11 (INT1)
 
 // Botões
 #define UP_BUTTON     11
@@ -55,111 +65,242 @@ float trigger_l_max = 30.0;
 
 // Buzzer
 #define BUZZER_PIN     13
-bool buzzerOn          = false; // Indica se o buzzer está ligado
-bool buzzerTempReason  = false; // Indica se o buzzer foi ligado especificamente por causa da temperatura
-bool buzzerHumdReason  = false; // Indica se o buzzer foi ligado especificamente por causa da umidade
-bool buzzerLightReason = false; // Indica se o buzzer foi ligado especificamente por causa da luminosidade
+
+// Regras de alerta padrão, usadas enquanto não houver uma tabela
+// gravada na EEPROM (ver alerts.h). Temperatura em centésimos de °C
+// e umidade em centésimos de %, qualquer que seja a escala exibida.
+// As mesmas regras decidem LEDs, buzzer e o registro de anomalias.
+const AlertRule defaultAlertRules[] PROGMEM = {
+  // canal           low   high  hist. debounce  LED      prioridade
+  { ALERT_CH_TEMP,  1500,  2500,   30,    3,     LED_GRE, 1 },
+  { ALERT_CH_HUMD,  4000,  6500,  200,    3,     LED_RED, 1 },
+  { ALERT_CH_LIGHT,    0,    30,    3,    5,     LED_YEL, 1 },
+};
 
 // LDR
-#define LDR_PIN A0
+#define LDR_PIN     A0
+#define LDR_CHANNEL 0     // canal do ADC de A0
 
 /************************************************************
  *               OBJETOS & VARIÁVEIS GLOBAIS                *
  ************************************************************/
-LiquidCrystal_I2C lcd(I2C_ADDR, LCD_COLUMNS, LCD_LINES);
+LiquidCrystal_I2C lcdDevice(I2C_ADDR, LCD_COLUMNS, LCD_LINES);
+LcdFrame          lcd(lcdDevice);   // o firmware desenha aqui; flush() envia as diferenças
+GlyphCache        glyphs(lcdDevice);
 
-// DHT
-DHT dht(DHTPIN, DHTTYPE);
+// DHT (leitura por interrupção, ver dht11.h)
+Dht11 dht(DHTPIN);
 
-// Menu
-int   menu              = 1;
-bool  rtcMenuActive     = false;
-bool  subMenuTempActive = false; 
-bool  homePageActive    = false;
-int   subMenuIndex      = 1;    // Índice no submenu de temperatura
+// Menu: árvore em flash (menuTable) percorrida pelo navegador de menu.h
+#define MENU_ITEM_HOME  2       // índice da tela HOME na tabela
 
 // Escala de temperatura (1=Celsius, 2=Fahrenheit, 3=Kelvin)
 int  temperatureScale = 1;
-float lastAvgTemp; // Armazena a última média de temperatura
-float lastAvgHumd; // Armazena a última média de umidade
 
-// Leituras de sensores
-float temp       = 0.0;
-float humid      = 0.0;
-int   lightLevel = 0;
+// Leituras e médias em ponto fixo: temperatura em centésimos de °C,
+// umidade em centésimos de %. A conversão para °F/K só é feita na
+// hora de exibir (toScale).
+int16_t lastAvgTemp = 0;   // Última média de temperatura
+int16_t lastAvgHumd = 0;   // Última média de umidade
+int16_t lastAvgLum  = 0;   // Última média de luminosidade (%)
 
-// Arrays de leituras (média)
-float tempReadings[10]; 
-float humdReadings[10];
-int   currentIndex = 0;
+// Leituras de sensores
+int16_t temp       = 0;
+int16_t humid      = 0;
+int     lightLevel = 0;
+bool    dhtValid   = false;   // já houve uma leitura do DHT11 com checksum OK
+bool    avgValid   = false;   // as médias já incluem leituras do DHT11
+bool    avgFresh   = false;   // média nova ainda não avaliada pelos alertas
 
-unsigned long lastHomeUpdate = 0;
 long totalLeituras = 0;
+int  valorLDR      = 0;   // leitura do LDR em 12 bits (sobreamostrada)
+
+// Períodos das tarefas do agendador (ms)
+#define SAMPLE_PERIOD_MS   100
+#define AVERAGE_PERIOD_MS  1000
+#define RECORD_PERIOD_MS   1000
+#define SERIAL_PERIOD_MS   1000
+#define DISPLAY_PERIOD_MS  1000
+#define RX_PERIOD_MS       50     // a 9600 baud, o buffer de 64 bytes enche em 67 ms
+
+// Médias por janela de tempo, independentes da taxa de amostragem
+#define AVERAGE_WINDOW_MS  1000
+ChannelStats<int16_t> tempStats(AVERAGE_WINDOW_MS);
+ChannelStats<int16_t> humdStats(AVERAGE_WINDOW_MS);
+ChannelStats<int16_t> lumStats(AVERAGE_WINDOW_MS);
+
+// Botões (PORTB, lidos por interrupção; ver buttons.h)
+const uint8_t buttonPins[] = {UP_BUTTON, DOWN_BUTTON, SELECT_BUTTON, BACK_BUTTON};
+
+// Temporizador que volta ao menu após "Escala defin."
+int timerMenuReturn = -1;
+// Temporizador das etapas do DHT11
+int timerDht        = -1;
+// Temporizador da leitura dos botões (só com bordas ou prazos pendentes)
+int timerInput      = -1;
+
+// Luz de fundo do LCD: apaga sem uso dos botões
+#define BACKLIGHT_TIMEOUT_MS 60000
+int  timerBacklight = -1;
+bool backlightOn    = false;
+
+// Quadros recebidos pela serial (pedidos de exportação do log); o
+// texto fora dos quadros vai para o interpretador de comandos
+TelemetryReceiver serialReceiver;
+bool    rxInFrame    = false;
+uint8_t rxFrameBytes = 0;
+// Temporizador da exportação do log, que se reagenda até o fim
+int timerExport = -1;
+// Gravação dos episódios na EEPROM, um byte por passada
+int timerEpisodes = -1;
+// Gravação do bloco aberto do log, um pedaço por passada
+int timerLogSave = -1;
+
+// Saída serial em relatórios: a leitura periódica e os eventos são
+// guardados aqui e escritos uma linha (ou um quadro) por passada de
+// taskSerialRx(), só com espaço na TX; nada espera pela UART.
+// Durante a exportação ou uma listagem do shell os eventos esperam
+// na fila, e da leitura periódica fica só a mais recente (o 'seq'
+// dos quadros mostra as que não saíram).
+#define REPORT_NONE     0
+#define REPORT_SAMPLE   1
+#define REPORT_EPISODE  2
+#define REPORT_RECORD   3
+#define REPORT_QUEUE    8       // eventos pendentes (potência de 2)
+
+struct SerialReport {
+  uint8_t kind;                 // REPORT_*
+  uint8_t event;                // EPISODE_* (REPORT_EPISODE)
+  long    number;               // número da leitura (REPORT_SAMPLE)
+  union {
+    TelemetrySample sample;
+    Episode         episode;
+    LogSample       record;
+  };
+};
+
+SpscRing<SerialReport, REPORT_QUEUE> reportQueue;
+SerialReport    report;               // em escrita (kind = REPORT_NONE: nenhum)
+uint8_t         reportLine    = 0;    // próxima linha do relatório em escrita
+SerialReport    pendingSample;        // leitura mais recente ainda não escrita
+bool            samplePending = false;
 
-DateTime adjustedTime;
-DateTime now;
 
 
 /************************************************************
- *                 FUNÇÃO PARA DESLIGAR ALERTAS             *
+ *                        PROTÓTIPOS                        *
  ************************************************************/
-void turnOffAllAlerts() {
-  // Desliga LEDs
-  digitalWrite(LED_RED, LOW);
-  digitalWrite(LED_GRE, LOW);
-  digitalWrite(LED_YEL, LOW);
-
-  // Desliga Buzzer
-  noTone(BUZZER_PIN);
-
-  // Zera flags
-  buzzerOn          = false;
-  buzzerTempReason  = false;
-  buzzerHumdReason  = false;
-  buzzerLightReason = false;
-}
+// Necessários para compilar como C++ comum (PlatformIO, build de
+// host); a IDE do Arduino gera estes protótipos sozinha.
+void taskSample();
+void taskAverage();
+void taskRecord();
+void taskSerial();
+void taskDisplay();
+void taskInput();
+void taskDht();
+void taskClock();
+void taskSerialRx();
+void taskExport();
+void taskEpisodes();
+void taskLogSave();
+void backlightOff();
+void onButtonEvent(uint8_t button, uint8_t event);
+void onButtonPress(int button);
+void menuScale(uint8_t scale);
+void menuHome(uint8_t arg);
+void menuHomeRefresh(uint8_t arg);
+void menuRtc(uint8_t arg);
+void showHomeValues();
+void homePage();
+void welcome();
+void wizard1();
+void wizard2();
+void magic();
+void displayRTC();
+void updateAverages();
+void checkAlerts(bool newLight);
+void get_log(uint32_t from = 0, uint32_t to = 0xFFFFFFFF, uint8_t channels = 0, uint16_t limit = 0);
+void get_episodes();
+void get_trend(uint32_t from = 0, uint32_t to = 0xFFFFFFFF, uint32_t step = 3600);
+void get_profile();
+void recordEEPROM();
+void recordTrend();
+void serialLog(int16_t temp, int16_t humid, int valorLDR, long leituraNum);
+bool reportStep();
+void sendFrame(const uint8_t* payload, size_t len);
+bool serialBusy();
+extern const ShellCommand shellCommands[];
+extern const uint8_t      shellCommandCount;
+extern const MenuItem     menuTable[];
+char scaleLetter();
+int16_t toCenti(float value);
+int32_t toScale(int16_t centiCelsius);
 
 
 /************************************************************
  *                          SETUP                           *
  ************************************************************/
+// Id devolvido pelo registro de uma tarefa no agendador. Com a tabela
+// cheia o registro devolve -1 e startTimer() ignoraria a tarefa sem
+// aviso: melhor parar aqui, dizendo o porquê.
+static int registered(int id) {
+  if (id < 0) {
+    Serial.println(F("agendador cheio: aumente MAX_TASKS"));
+    Serial.flush();
+    while(1);
+  }
+  return id;
+}
+
 void setup() {
-  Serial.begin(9600);
-  rtc.begin();
-  rtc.adjust(DateTime(F(__DATE__), F(__TIME__)));
+  Serial.begin(SERIAL_BAUD);
   EEPROM.begin();
 
   if(! rtc.begin()) {
-    Serial.println("DS3231 não encontrado");
+    Serial.println(F("DS3231 não encontrado"));
     while(1);
   }
+  // Só acerta o relógio se ele parou: reajustar a cada boot faria o
+  // tempo voltar e quebraria a ordem temporal do log na EEPROM.
   if(rtc.lostPower()){
-    Serial.println("DS3231 OK!");
-    rtc.adjust(DateTime(2025, 3, 20, 19, 30, 45));
+    Serial.println(F("DS3231 OK!"));
+    // __DATE__/__TIME__ são a hora local da compilação; o RTC guarda UTC
+    rtc.adjust(DateTime(F(__DATE__), F(__TIME__)) - TimeSpan((int32_t)UTC_OFFSET * 3600));
   }
+  // Log na AT24C32 do módulo do RTC (ou na EEPROM interna, sem ela):
+  // depende da Wire, iniciada por rtc.begin()
+  logBegin();
+  episodesBegin();
+  // Daqui em diante a hora vem do relógio local, que anda pelo SQW
+  clockBegin(rtc, RTC_SQW_PIN, UTC_OFFSET);
+  // Arquivo de tendências na mesma camada do log; refaz a hora e o
+  // dia em curso com o que já estava gravado
+  archiveBegin(clockUnix());
   delay(100);
   
-  // Inicialização dos pinos de botões
-  pinMode(UP_BUTTON,     INPUT_PULLUP);
-  pinMode(DOWN_BUTTON,   INPUT_PULLUP);
-  pinMode(SELECT_BUTTON, INPUT_PULLUP);
-  pinMode(BACK_BUTTON,   INPUT_PULLUP);
+  // Botões com pull-up; as bordas chegam pela interrupção PCINT0
+  buttonsBegin(buttonPins, sizeof(buttonPins), onButtonEvent);
 
   // Buzzer e LEDs
   pinMode(BUZZER_PIN, OUTPUT);
   pinMode(LED_RED,    OUTPUT);
   pinMode(LED_YEL,    OUTPUT);
   pinMode(LED_GRE,    OUTPUT);
+  alertBegin(BUZZER_PIN, defaultAlertRules,
+             sizeof(defaultAlertRules) / sizeof(defaultAlertRules[0]));
 
   // LDR
   pinMode(LDR_PIN, INPUT);
+  ldrBegin(LDR_CHANNEL);
 
-  // Inicializa o DHT
+  // Inicializa o DHT (linha em repouso, sem transação em curso)
   dht.begin();
 
   // LCD
-  lcd.init();
-  lcd.backlight();
+  lcdDevice.init();
+  lcdDevice.backlight();
+  backlightOn = true;
 
   // Animações de introdução
   lcd.clear();
@@ -173,11 +314,42 @@ void setup() {
   
   lcd.clear();
   lcd.setCursor(4, 0);
-  lcd.print("Loading");
+  lcd.print(F("Loading"));
+  lcd.flush();
   delay(1500);
 
   // Exibe o menu principal ao iniciar
-  exibir_menu();
+  menuBegin(lcd, menuTable);
+  menuShow();
+
+  // Tarefas em ordem de prioridade: amostragem primeiro.
+  // O prazo é o atraso tolerado antes de contar a execução como atrasada.
+  registered(scheduler.addPeriodic(PSTR("sample"),  taskSample,  SAMPLE_PERIOD_MS,  SAMPLE_PERIOD_MS / 2));
+  registered(scheduler.addPeriodic(PSTR("average"), taskAverage, AVERAGE_PERIOD_MS, SAMPLE_PERIOD_MS, 50));
+  registered(scheduler.addPeriodic(PSTR("record"),  taskRecord,  RECORD_PERIOD_MS,  RECORD_PERIOD_MS / 2, 150));
+  registered(scheduler.addPeriodic(PSTR("serial"),  taskSerial,  SERIAL_PERIOD_MS,  SERIAL_PERIOD_MS / 2, 250));
+  registered(scheduler.addPeriodic(PSTR("display"), taskDisplay, DISPLAY_PERIOD_MS, DISPLAY_PERIOD_MS / 2, 350));
+  registered(scheduler.addPeriodic(PSTR("clock"),   taskClock,   CLOCK_RESYNC_MS,   CLOCK_RESYNC_MS / 2, CLOCK_RESYNC_MS));
+  registered(scheduler.addPeriodic(PSTR("rx"),      taskSerialRx, RX_PERIOD_MS,      RX_PERIOD_MS, 25));
+  timerMenuReturn = registered(scheduler.addTimer(PSTR("menu"), menuShow));
+  timerInput      = registered(scheduler.addTimer(PSTR("input"), taskInput));
+
+  // O DHT11 agenda a si mesmo: cada etapa diz quanto esperar
+  timerDht = registered(scheduler.addTimer(PSTR("dht"), taskDht));
+  scheduler.startTimer(timerDht, 0);
+
+  timerBacklight = registered(scheduler.addTimer(PSTR("backlight"), backlightOff));
+  scheduler.startTimer(timerBacklight, BACKLIGHT_TIMEOUT_MS);
+
+  timerExport = registered(scheduler.addTimer(PSTR("export"), taskExport));
+  timerEpisodes = registered(scheduler.addTimer(PSTR("episodes"), taskEpisodes));
+  timerLogSave  = registered(scheduler.addTimer(PSTR("logsave"), taskLogSave));
+
+  // Comandos de texto pela serial (ver shell.h e taskSerialRx)
+  shellBegin(Serial, shellCommands, shellCommandCount);
+
+  // Sono entre tarefas e watchdog
+  powerBegin();
 }
 
 
@@ -185,299 +357,276 @@ void setup() {
  *                          LOOP                            *
  ************************************************************/
 void loop() {
-
-  // Controla a frequência da impressão serial
-  static unsigned long lastSerialTime = 0;
-
-  // ==== LEITURA DE SENSORES ====
-  int valorLDR   = analogRead(LDR_PIN);
-  lightLevel     = map(valorLDR, 40, 950, 0, 100);
-
-  float tempRaw  = dht.readTemperature(); // Celsius
-  float humRaw   = dht.readHumidity();
-
-  if (!isnan(tempRaw)) {
-    // Converte a temperatura conforme a escala
-    switch (temperatureScale) {
-      case 1: // Celsius
-        temp = tempRaw;
-        break;
-      case 2: // Fahrenheit
-        temp = (tempRaw * 1.8) + 32;
-        break;
-      case 3: // Kelvin
-        temp = tempRaw + 273.15;
-        break;
-    }
+  // Bordas novas dos botões: a leitura roda nesta mesma passada
+  if (buttonsPending()) scheduler.startTimer(timerInput, 0);
+
+  // Todo o trabalho é feito pelas tarefas do agendador; nenhuma
+  // delas espera pela UART (a saída sai aos poucos, ver
+  // taskSerialRx), então a latência de cada passada é limitada.
+  {
+    PROFILE_SCOPE(PROF_PASS);
+    scheduler.run();
   }
 
-  if (!isnan(humRaw)) {
-    humid = humRaw; // umidade em %
+  // O que as tarefas desenharam nesta passada vai ao display de uma
+  // vez, só nas células que mudaram
+  {
+    PROFILE_SCOPE(PROF_LCD);
+    lcd.flush();
   }
 
-  tempReadings[currentIndex] = temp;
-  humdReadings[currentIndex] = humid;
-  currentIndex = (currentIndex + 1) % 10;
+  // Dorme até a próxima tarefa vencer (ou um botão mudar)
+  powerKick();
+  powerIdle(scheduler.msUntilNextRun());
+}
+
 
-  if (currentIndex == 9) {
-    tenthRead();
+/************************************************************
+ *                         TAREFAS                          *
+ ************************************************************/
+// ==== LEITURA DE SENSORES ====
+void taskSample() {
+  // Amostras do LDR já convertidas e filtradas pela ISR do ADC; a
+  // fila guarda as que chegaram desde a última passada
+  uint16_t raw;
+  bool     newLight = false;
+  while (ldrRead(raw)) {
+    valorLDR = raw;
+    newLight = true;
+  }
+  if (newLight) {
+    lightLevel = map(valorLDR, 40L << LDR_EXTRA_BITS, 950L << LDR_EXTRA_BITS, 0, 100);
   }
 
-  // Exibição serial a cada ~1s
-  if (millis() - lastSerialTime >= 1000UL) {
-    lastSerialTime = millis();
-    totalLeituras++;
-    serialLog(temp, humid, valorLDR, totalLeituras);
+  // Leitura nova do DHT11, se a última transação terminou bem;
+  // senão mantém a anterior
+  if (dht.available() && dht.status() == DHT11_OK) {
+    temp     = dht.temperature();
+    humid    = dht.humidity();
+    dhtValid = true;
   }
 
-  // Verifica e registra anomalias na EEPROM
-  recordEEPROM();
+  uint32_t nowMs = millis();
+  if (dhtValid) {
+    // Antes da primeira leitura não há o que somar às médias
+    tempStats.add(temp, nowMs);
+    humdStats.add(humid, nowMs);
+  }
+  lumStats.add(lightLevel, nowMs);
 
-  if (homePageActive) {
-    // Verifica luminosidade só enquanto em HOME
-    checkLightAlert();
+  checkAlerts(newLight);
+}
 
-    // A cada 1s, atualiza a tela
-    if (millis() - lastHomeUpdate >= 1000UL) {
-      lastHomeUpdate = millis();
-      showHomeValues();
-    }
-  }
-  else {
-    // Se não está na HOME, desliga todos os alertas
-    turnOffAllAlerts();
-  }
+// ==== MÉDIAS ====
+void taskAverage() {
+  updateAverages();
+}
 
-  // ==== SUBMENU DE TEMPERATURA ====
-  if (subMenuTempActive) {
-    if (!digitalRead(BACK_BUTTON)) {
-      subMenuTempActive = false;
-      exibir_menu();
-      delay(100);
-      while (!digitalRead(BACK_BUTTON));
-    }
+// ==== REGISTRO DE ANOMALIAS ====
+void taskRecord() {
+  PROFILE_SCOPE(PROF_RECORD);
+  recordEEPROM();
+  recordTrend();
+  logPoll();
+  if (logSaving()) scheduler.startTimer(timerLogSave, 0);
+}
 
-    if (!digitalRead(DOWN_BUTTON)) {
-      subMenuIndex++;
-      if (subMenuIndex > 3) subMenuIndex = 3;
-      exibir_submenu_temp();
-      delay(100);
-      while (!digitalRead(DOWN_BUTTON));
-    }
+// ==== LOG SERIAL ====
+void taskSerial() {
+  PROFILE_PERIOD(PROF_JITTER_SERIAL, SERIAL_PERIOD_MS);
+  PROFILE_SCOPE(PROF_SERIAL);
+  totalLeituras++;
+  // Só o retrato desta leitura; quem escreve é taskSerialRx()
+  serialLog(temp, humid, valorLDR, totalLeituras);
+}
 
-    if (!digitalRead(UP_BUTTON)) {
-      subMenuIndex--;
-      if (subMenuIndex < 1) subMenuIndex = 1;
-      exibir_submenu_temp();
-      delay(100);
-      while (!digitalRead(UP_BUTTON));
+// ==== RECEPÇÃO E SAÍDA SERIAL ====
+// Quadros COBS do host vêm entre dois 0x00 (o host manda um antes
+// do quadro); o resto é texto para o interpretador de comandos. O
+// texto nunca tem 0x00, e um quadro sem o delimitador final é
+// abandonado depois de TELEMETRY_FRAME_MAX bytes.
+//
+// Na saída, o relatório em escrita termina antes de o shell rodar
+// uma linha nova, e as listagens do shell vão antes dos relatórios.
+void taskSerialRx() {
+  while (Serial.available() > 0) {
+    uint8_t byte = (uint8_t)Serial.read();
+
+    if (!rxInFrame) {
+      if (byte != 0x00) {
+        shellFeed(byte);
+        continue;
+      }
+      rxInFrame    = true;
+      rxFrameBytes = 0;
+      shellDiscard();
+      serialReceiver.feed(byte);
+      continue;
     }
 
-    if (!digitalRead(SELECT_BUTTON)) {
-      executeActionTemp();
-      subMenuTempActive = false;
-      exibir_menu();
-      delay(100);
-      while (!digitalRead(SELECT_BUTTON));
+    size_t len = serialReceiver.feed(byte);
+    if (byte != 0x00) {
+      if (++rxFrameBytes > TELEMETRY_FRAME_MAX) rxInFrame = false;
+      continue;
     }
-    return;
-  }
+    rxInFrame = false;
+    if (len == 0) continue;
 
-  // ==== TELA HOME ====
-  if (homePageActive) {
-    if (!digitalRead(BACK_BUTTON)) {
-      homePageActive = false;
-      exibir_menu();
-      delay(100);
-      while (!digitalRead(BACK_BUTTON));
-    }
-    return;
-  }
-
-  // ==== MENU PRINCIPAL ====
-  if (!digitalRead(DOWN_BUTTON)) {
-    menu++;
-    exibir_menu();
-    delay(100);
-    while (!digitalRead(DOWN_BUTTON));
-  }
-  if (!digitalRead(UP_BUTTON)) {
-    menu--;
-    exibir_menu();
-    delay(100);
-    while (!digitalRead(UP_BUTTON));
-  }
-  if (!digitalRead(SELECT_BUTTON)) {
-    executeAction();
-    if (!subMenuTempActive && !homePageActive) {
-      exibir_menu();
-    }
-    delay(100);
-    while (!digitalRead(SELECT_BUTTON));
-  }
-
-  // Se estiver no menu do RTC
-  if (rtcMenuActive) {
-    displayRTC();
-    if (!digitalRead(BACK_BUTTON)) {
-      rtcMenuActive = false;
-      exibir_menu();
-      delay(100);
-      while (!digitalRead(BACK_BUTTON));
+    TelemetryDumpRequest request;
+    if (LOG_OPTION && !serialBusy() &&
+        telemetryUnpackDumpRequest(serialReceiver.payload(), len, request)) {
+      scheduler.startTimer(timerExport, exportStart(request, SERIAL_BAUD));
     }
-    return;
   }
 
-  if (!digitalRead(DOWN_BUTTON)) {
-    menu++;
-    exibir_menu();
-    delay(100);
-    while (!digitalRead(DOWN_BUTTON));
-  }
-  if (!digitalRead(UP_BUTTON)) {
-    menu--;
-    exibir_menu();
-    delay(100);
-    while (!digitalRead(UP_BUTTON));
-  }
-  if (!digitalRead(SELECT_BUTTON)) {
-    executeAction();
-    delay(100);
-    while (!digitalRead(SELECT_BUTTON));
-  }
+  // Executa a linha digitada e anda a listagem em curso, só com
+  // espaço na TX; nada disso durante a exportação
+  if (exportActive()) return;
+  if (report.kind == REPORT_NONE) shellPoll();
+  if (!shellBusy() && Serial.availableForWrite() >= SERIAL_OUTPUT_ROOM) reportStep();
 }
 
+// ==== EXPORTAÇÃO DO LOG ====
+void taskExport() {
+  if (exportStep()) scheduler.startTimer(timerExport, 0);
+}
 
-/************************************************************
- *                       FUNÇÕES MENU                       *
- ************************************************************/
-void exibir_menu() {
-  switch (menu) {
-    case 0:
-      menu = 1;
-      break;
-    case 1:
-      lcd.clear();
-      lcd.print(">ESCALA TEMP.");
-      lcd.setCursor(0, 1);
-      lcd.print(" HOME");
-      break;
-    case 2:
-      lcd.clear();
-      lcd.print(" ESCALA TEMP.");
-      lcd.setCursor(0, 1);
-      lcd.print(">HOME");
-      break;
-    case 3:
-      lcd.clear();
-      lcd.print(" HOME");
-      lcd.setCursor(0, 1);
-      lcd.print(">RTC");
-      break;
-    case 4:
-      menu = 3;
-      break;
-  }
+// ==== GRAVAÇÃO DOS EPISÓDIOS ====
+// Um byte (~3,3 ms) por passada, até acabar o que está pendente
+void taskEpisodes() {
+  if (episodesSaveStep()) scheduler.startTimer(timerEpisodes, 0);
 }
 
-void exibir_submenu_temp() {
-  lcd.clear();
-  switch (subMenuIndex) {
-    case 0:
-      subMenuIndex = 1;
-    case 1:
-      lcd.clear();
-      lcd.print(">CELSIUS");
-      lcd.setCursor(0, 1);
-      lcd.print(" FAHRENHEIT");
-      break;
-    case 2:
-      lcd.clear();
-      lcd.print(" CELSIUS");
-      lcd.setCursor(0, 1);
-      lcd.print(">FAHRENHEIT");
-      break;
-    case 3:
-      lcd.clear();
-      lcd.print(" FAHRENHEIT");
-      lcd.setCursor(0, 1);
-      lcd.print(">KELVIN");
-      break;
-    case 4:
-      subMenuIndex = 3;
-      break;
-  }
+// ==== GRAVAÇÃO DO LOG ====
+// Um pedaço por passada; na AT24C32, a espera do ciclo de escrita é
+// uma sondagem por passada, AT24_POLL_MS depois da anterior
+void taskLogSave() {
+  uint16_t wait = logSaveStep();
+  if (wait != LOG_SAVE_IDLE) scheduler.startTimer(timerLogSave, wait);
 }
 
-void executeActionTemp() {
-  switch (subMenuIndex) {
-    case 1: temperatureScale = 1; break; // Celsius
-    case 2: temperatureScale = 2; break; // Fahrenheit
-    case 3: temperatureScale = 3; break; // Kelvin
-  }
-  lcd.clear();
-  lcd.print("Escala defin.");
-  delay(1000);
+// ==== RESSINCRONIZAÇÃO DO RELÓGIO ====
+void taskClock() {
+  PROFILE_SCOPE(PROF_CLOCK);
+  clockResync();
 }
 
-void executeAction() {
-  switch (menu) {
-    case 1:
-      subMenuTempActive = true;
-      subMenuIndex      = 1;
-      exibir_submenu_temp();
+// ==== LUZ DE FUNDO ====
+void backlightOff() {
+  lcdDevice.noBacklight();
+  backlightOn = false;
+}
+
+// ==== ATUALIZAÇÃO DO LCD ====
+void taskDisplay() {
+  PROFILE_PERIOD(PROF_JITTER_DISPLAY, DISPLAY_PERIOD_MS);
+  PROFILE_SCOPE(PROF_DISPLAY);
+  // HOME e RTC: a tela aberta no menu se redesenha
+  menuRefresh();
+}
+
+// ==== DHT11 ====
+// Executa uma etapa da transação e se reagenda para a próxima
+void taskDht() {
+  PROFILE_SCOPE(PROF_DHT);
+  scheduler.startTimer(timerDht, dht.poll());
+}
+
+// ==== BOTÕES ====
+// Consome as bordas gravadas pela ISR e volta só quando houver um
+// prazo (debounce, long-press, repetição) ou uma borda nova
+void taskInput() {
+  unsigned long wait = buttonsPoll();
+  if (wait != BUTTONS_IDLE) scheduler.startTimer(timerInput, wait);
+}
+
+void onButtonEvent(uint8_t button, uint8_t event) {
+  switch (event) {
+    case BUTTON_PRESS:
+      onButtonPress(button);
       break;
-    case 2:
-      showHomePage();
+    case BUTTON_REPEAT:
+      // Segurar UP/DOWN percorre a lista
+      if (button == UP_BUTTON || button == DOWN_BUTTON) onButtonPress(button);
       break;
-    case 3:
-      rtcMenuActive = true;
-      lcd.clear();
-      while (rtcMenuActive) {
-        displayRTC();
-        delay(1000);
-
-        if (!digitalRead(BACK_BUTTON)) {
-          rtcMenuActive = false;
-          exibir_menu();
-          delay(100);
-          while (!digitalRead(BACK_BUTTON));
-        }
-      }
+    case BUTTON_LONG:
+      // Segurar BACK volta ao menu principal de qualquer tela
+      if (button == BACK_BUTTON) menuTop();
       break;
   }
 }
 
-void showHomeValues() {
-  // Determina o sufixo de temperatura
-  char tempSuffix = 'C';
-  if (temperatureScale == 2)      tempSuffix = 'F';
-  else if (temperatureScale == 3) tempSuffix = 'K';
+void onButtonPress(int button) {
+  // Qualquer tecla acende a luz de fundo e adia o desligamento
+  if (!backlightOn) {
+    lcdDevice.backlight();
+    backlightOn = true;
+  }
+  scheduler.startTimer(timerBacklight, BACKLIGHT_TIMEOUT_MS);
 
-  String tempStr  = String(lastAvgTemp, 0) + tempSuffix;
-  String lightStr = String(lightLevel) + "%";
-  String humStr   = String(lastAvgHumd, 0) + "%";
+  switch (button) {
+    case UP_BUTTON:     menuKey(MENU_KEY_UP);     break;
+    case DOWN_BUTTON:   menuKey(MENU_KEY_DOWN);   break;
+    case SELECT_BUTTON: menuKey(MENU_KEY_SELECT); break;
+    case BACK_BUTTON:   menuKey(MENU_KEY_BACK);   break;
+  }
+}
 
-  // Limpa toda a linha 1 antes de imprimir novos valores
-  lcd.setCursor(0, 1);
-  lcd.print("                ");
 
-  //  Exibe temp, lum, umidade
-  lcd.setCursor(0, 1);
-  lcd.print(tempStr);
+/************************************************************
+ *                       FUNÇÕES MENU                       *
+ ************************************************************/
+// Comando dos itens de escala: 1=Celsius, 2=Fahrenheit, 3=Kelvin
+void menuScale(uint8_t scale) {
+  temperatureScale = scale;
+  lcd.print(F("Escala defin."));
+  // Mantém a mensagem por 1s sem travar o loop
+  scheduler.startTimer(timerMenuReturn, 1000);
+}
 
-  lcd.setCursor(6, 1);
-  lcd.print(lightStr);
+void menuHome(uint8_t arg) {
+  homePage();
+}
 
-  lcd.setCursor(12, 1);
-  lcd.print(humStr);
+void menuHomeRefresh(uint8_t arg) {
+  showHomeValues();
 }
 
-void showHomePage() {
-  lcd.clear();
-  homePageActive = true;
-  homePage();
-  lastHomeUpdate = millis();
+// A tela é atualizada a cada 1s por taskDisplay()
+void menuRtc(uint8_t arg) {
+  displayRTC();
+}
+
+const char labelScale[]      PROGMEM = "ESCALA TEMP.";
+const char labelHome[]       PROGMEM = "HOME";
+const char labelRtc[]        PROGMEM = "RTC";
+const char labelCelsius[]    PROGMEM = "CELSIUS";
+const char labelFahrenheit[] PROGMEM = "FAHRENHEIT";
+const char labelKelvin[]     PROGMEM = "KELVIN";
+
+// Os filhos de cada item ficam em sequência (ver menu.h)
+const MenuItem menuTable[] PROGMEM = {
+  // rótulo          comando/tela  redesenho         arg  pai        filhos
+  { NULL,            NULL,         NULL,              0,  MENU_NONE, 1, 3 },  // 0 raiz
+  { labelScale,      NULL,         NULL,              0,  0,         4, 3 },  // 1
+  { labelHome,       menuHome,     menuHomeRefresh,   0,  0,         0, 0 },  // 2 MENU_ITEM_HOME
+  { labelRtc,        menuRtc,      menuRtc,           0,  0,         0, 0 },  // 3
+  { labelCelsius,    menuScale,    NULL,              1,  1,         0, 0 },  // 4
+  { labelFahrenheit, menuScale,    NULL,              2,  1,         0, 0 },  // 5
+  { labelKelvin,     menuScale,    NULL,              3,  1,         0, 0 },  // 6
+};
+
+void showHomeValues() {
+  // Linha 1 inteira (temp, lum, umidade), completada com espaços
+  // para apagar o que sobrou da leitura anterior
+  TextBuf<LCD_COLUMNS + 1> row;
+  row.fixed(toScale(lastAvgTemp), FMT_CENTI_0).character(scaleLetter());
+  row.padTo(6).fixed((int32_t)lastAvgLum, FMT_PERCENT);
+  row.padTo(12).fixed((int32_t)lastAvgHumd, FMT_CENTI_0).character('%');
+  row.padTo(LCD_COLUMNS);
+
+  lcd.setCursor(0, 1);
+  lcd.print(row.c_str());
 }
 
 
@@ -485,22 +634,14 @@ void showHomePage() {
  *                       FUNÇÕES HOME                       *
  ************************************************************/
 void homePage() {
-  byte name0x1[]  = { B01110, B01010, B01010, B01010, B11111, B11111, B11111, B01110 };
-  byte name0x7[]  = { B00001, B00010, B00100, B01000, B11111, B00010, B00100, B01000 };
-  byte name0x13[] = { B00100, B00100, B01110, B01110, B11111, B11111, B11111, B01110 };
-
-  lcd.createChar(0, name0x1);
-  lcd.createChar(1, name0x7);
-  lcd.createChar(2, name0x13);
-
-  lcd.setCursor(1, 0); 
-  lcd.write((uint8_t)0);
+  lcd.setCursor(1, 0);
+  lcd.write(glyphs.slot(GLYPH_THERMOMETER));
 
   lcd.setCursor(7, 0);
-  lcd.write((uint8_t)1);
+  lcd.write(glyphs.slot(GLYPH_LIGHTNING));
 
   lcd.setCursor(13, 0);
-  lcd.write((uint8_t)2);
+  lcd.write(glyphs.slot(GLYPH_DROP));
 
   showHomeValues();
 }
@@ -510,19 +651,22 @@ void homePage() {
  *                FUNÇÕES DE ANIMAÇÃO/TELAS                 *
  ************************************************************/
 void welcome() {
-  String line = "SEJA BEM VINDO";
-  for (int i = 0; i < (int)line.length(); i++) {
+  static const char line[] PROGMEM = "SEJA BEM VINDO";
+  char c;
+  for (int i = 0; (c = (char)pgm_read_byte(&line[i])) != '\0'; i++) {
     lcd.setCursor(i + 1, 0);
-    lcd.print(line[i]);
+    lcd.print(c);
+    lcd.flush();
     delay(150);
 
     // Efeito de 'cair'
     lcd.setCursor(i + 1, 0);
-    lcd.print(" ");
+    lcd.print(F(" "));
     lcd.setCursor(i + 1, 1);
-    lcd.print(line[i]);
+    lcd.print(c);
+    lcd.flush();
 
-    if (!isWhitespace(line[i])) {
+    if (!isWhitespace(c)) {
       tone(BUZZER_PIN, 250);
       delay(150);
       noTone(BUZZER_PIN);
@@ -531,425 +675,780 @@ void welcome() {
 }
 
 void wizard1() {
-  byte name1x4[] = {
-    B00000, B00000, B00000, B00000,
-    B00000, B00000, B00000, B00000
-  };
-  byte name0x0[] = {
-    B00000, B00000, B00000, B00000,
-    B00000, B00000, B00000, B00001
-  };
-  byte name0x1[] = {
-    B00000, B01000, B10100, B00100,
-    B01110, B01110, B11111, B11111
-  };
-  byte name0x2[] = {
-    B00000, B00000, B00000, B00000,
-    B00000, B00000, B00000, B10000
-  };
-  byte name1x0[] = {
-    B00000, B00000, B00001, B00010,
-    B00010, B00010, B00010, B00010
-  };
-  byte name1x1[] = {
-    B10001, B11011, B10001, B01010,
-    B00100, B00000, B00100, B00100
-  };
-  byte name1x2[] = {
-    B00010, B00101, B10010, B01010,
-    B01010, B01110, B01010, B01000
-  };
-
-  lcd.createChar(0, name1x4);
-  lcd.createChar(1, name0x0);
-  lcd.createChar(2, name0x1);
-  lcd.createChar(3, name0x2);
-  lcd.createChar(4, name1x0);
-  lcd.createChar(5, name1x1);
-  lcd.createChar(6, name1x2);
-
-  lcd.setCursor(4, 1); 
-  lcd.write(0);
-  lcd.setCursor(0, 0); 
-  lcd.write(1);
-  lcd.setCursor(1, 0); 
-  lcd.write(2);
-  lcd.setCursor(2, 0); 
-  lcd.write(3);
-  lcd.setCursor(0, 1); 
-  lcd.write(4);
-  lcd.setCursor(1, 1); 
-  lcd.write(5);
-  lcd.setCursor(2, 1); 
-  lcd.write(6);
+  lcd.setCursor(0, 0);
+  lcd.write(glyphs.slot(GLYPH_HAT_LEFT));
+  lcd.write(glyphs.slot(GLYPH_HAT));
+  lcd.write(glyphs.slot(GLYPH_HAT_RIGHT));
+  lcd.setCursor(0, 1);
+  lcd.write(glyphs.slot(GLYPH_ROBE));
+  lcd.write(glyphs.slot(GLYPH_FACE));
+  lcd.write(glyphs.slot(GLYPH_WAND_UP));
 
+  lcd.flush();
   delay(400);
   lcd.clear();
 }
 
 void wizard2() {
-  byte name1x2[] = {
-    B00000, B00000, B10000, B01000,
-    B01001, B01110, B01010, B01000
-  };
-  byte name0x0[] = {
-    B00000, B00000, B00000, B00000,
-    B00000, B00000, B00000, B00001
-  };
-  byte name0x1[] = {
-    B00000, B01000, B10100, B00100,
-    B01110, B01110, B11111, B11111
-  };
-  byte name0x2[] = {
-    B00000, B00000, B00000, B00000,
-    B00000, B00000, B00000, B10000
-  };
-  byte name1x0[] = {
-    B00000, B00000, B00001, B00010,
-    B00010, B00010, B00010, B00010
-  };
-  byte name1x1[] = {
-    B10001, B11011, B10001, B01010,
-    B00100, B00000, B00100, B00100
-  };
-  byte name1x3[] = {
-    B00100, B01010, B01100, B10000,
-    B00000, B00000, B00000, B00000
-  };
-
-  lcd.createChar(0, name1x2);
-  lcd.createChar(1, name0x0);
-  lcd.createChar(2, name0x1);
-  lcd.createChar(3, name0x2);
-  lcd.createChar(4, name1x0);
-  lcd.createChar(5, name1x1);
-  lcd.createChar(6, name1x3);
-
-  lcd.setCursor(2, 1); 
-  lcd.write(0);
-  lcd.setCursor(0, 0); 
-  lcd.write(1);
-  lcd.setCursor(1, 0); 
-  lcd.write(2);
-  lcd.setCursor(2, 0); 
-  lcd.write(3);
-  lcd.setCursor(0, 1); 
-  lcd.write(4);
-  lcd.setCursor(1, 1); 
-  lcd.write(5);
-  lcd.setCursor(3, 1); 
-  lcd.write(6);
+  lcd.setCursor(0, 0);
+  lcd.write(glyphs.slot(GLYPH_HAT_LEFT));
+  lcd.write(glyphs.slot(GLYPH_HAT));
+  lcd.write(glyphs.slot(GLYPH_HAT_RIGHT));
+  lcd.setCursor(0, 1);
+  lcd.write(glyphs.slot(GLYPH_ROBE));
+  lcd.write(glyphs.slot(GLYPH_FACE));
+  lcd.write(glyphs.slot(GLYPH_WAND_DOWN));
+  lcd.write(glyphs.slot(GLYPH_SPARK));
 }
 
 void magic() {
-  String word = "MAGITECH!";
-  byte ball[] = {
-    B00100, B01110, B00100, B00000,
-    B00000, B00000, B00000, B00000
-  };
-
-  lcd.createChar(7, ball);
+  static const char word[] PROGMEM = "MAGITECH!";
+  uint8_t ball = glyphs.slot(GLYPH_BALL);
 
   int startPos   = 4;
   int endPos     = 15;
   int frameDelay = 200;
 
   lcd.setCursor(startPos, 1);
-  lcd.write(byte(7));
+  lcd.write(ball);
 
   for (int pos = startPos + 1; pos <= endPos; pos++) {
+    lcd.flush();
     delay(frameDelay);
 
     // "apaga" a posição anterior
     lcd.setCursor(pos - 1, 1);
-    lcd.print(" ");
+    lcd.print(F(" "));
 
     // desenha na nova posição
     lcd.setCursor(pos, 1);
-    lcd.write(byte(7));
+    lcd.write(ball);
 
     if (pos >= 6) {
       int letterIndex = pos - 6;
-      if (letterIndex < (int)word.length()) {
+      if (letterIndex < (int)sizeof(word) - 1) {
         lcd.setCursor(pos - 1, 1);
-        lcd.print(word[letterIndex]);
+        lcd.print((char)pgm_read_byte(&word[letterIndex]));
       }
     }
   }
 
+  lcd.flush();
   delay(500);
   lcd.setCursor(endPos, 1);
-  lcd.print(" ");
+  lcd.print(F(" "));
+  lcd.flush();
   delay(500);
 }
 
 void displayRTC() {
-  DateTime adjustedTime = rtc.now();
+  DateTime adjustedTime = clockNow();
+  TextBuf<LCD_COLUMNS + 1> row;
+
   lcd.clear();
   lcd.setCursor(0, 0);
-  lcd.print("DATA: ");
-  lcd.print(adjustedTime.day() < 10 ? "0" : "");
-  lcd.print(adjustedTime.day());
-  lcd.print("/");
-  lcd.print(adjustedTime.month() < 10 ? "0" : ""); 
-  lcd.print(adjustedTime.month());
-  lcd.print("/");
-  lcd.print(adjustedTime.year());
+  row.text(F("DATA: ")).time(adjustedTime, TIME_BR_DATE);
+  lcd.print(row.c_str());
 
   lcd.setCursor(0, 1);
-  lcd.print("HORA: ");
-  lcd.print(adjustedTime.hour() < 10 ? "0" : ""); 
-  lcd.print(adjustedTime.hour());
-  lcd.print(":");
-  lcd.print(adjustedTime.minute() < 10 ? "0" : ""); 
-  lcd.print(adjustedTime.minute());
-  lcd.print(":");
-  lcd.print(adjustedTime.second() < 10 ? "0" : ""); 
-  lcd.print(adjustedTime.second());
+  row.clear();
+  row.text(F("HORA: ")).time(adjustedTime, TIME_HMS);
+  lcd.print(row.c_str());
 }
 
 
 /************************************************************
  *                FUNÇÕES DE LEITURA/SENSORES               *
  ************************************************************/
-void tenthRead() {
-  float sumTemp = 0;
-  float sumHumd = 0;
+void updateAverages() {
+  // Sem amostras novas, a janela também precisa andar
+  uint32_t nowMs = millis();
+  tempStats.advance(nowMs);
+  humdStats.advance(nowMs);
+  lumStats.advance(nowMs);
+
+  if (tempStats.count() > 0) {
+    lastAvgTemp = tempStats.mean();
+    lastAvgHumd = humdStats.mean();
+    avgValid    = true;
+    avgFresh    = true;
+  }
+  lastAvgLum = lumStats.mean();
+}
 
-  for (int i = 0; i < 10; i++) {
-    sumTemp += tempReadings[i];
-    sumHumd += humdReadings[i];
+// ALERTAS
+void checkAlerts(bool newLight) {
+  // Uma passada pela tabela de regras a cada amostra, mas cada canal só
+  // é avaliado com um valor novo: a luz a cada amostra do LDR,
+  // temperatura e umidade a cada média nova (1 Hz, em °C,
+  // independentes da escala exibida). Reavaliar a mesma média a 10 Hz
+  // contaria dez vezes no debounce das regras.
+  int16_t values[ALERT_CHANNELS];
+  values[ALERT_CH_TEMP]  = lastAvgTemp;
+  values[ALERT_CH_HUMD]  = lastAvgHumd;
+  values[ALERT_CH_LIGHT] = lightLevel;
+
+  uint8_t fresh = newLight ? (1 << ALERT_CH_LIGHT) : 0;
+  if (avgFresh) {
+    fresh   |= (1 << ALERT_CH_TEMP) | (1 << ALERT_CH_HUMD);
+    avgFresh = false;
   }
+  alertEvaluate(values, fresh);
 
-  lastAvgTemp = sumTemp / 10;
-  lastAvgHumd = sumHumd / 10;
+  // LEDs e buzzer só na HOME; fora dela ficam desligados
+  alertOutputs(menuView() == MENU_ITEM_HOME);
+}
+
+/************************************************************
+ *                 LISTAGENS PELA SERIAL                    *
+ ************************************************************/
+// Cada listagem imprime um cabeçalho curto e registra um passo no
+// shell (shell.h), que sai uma linha (ou um pedaço dela) por vez,
+// só quando a TX da serial tem espaço. O estado da listagem em
+// curso fica aqui; o shell roda uma de cada vez.
+static LogCursor     logJob;
+static uint8_t       logColumns = LOG_CH_ALL;
+static ArchiveCursor trendJob;
+static ArchiveRecord trendRow;
+static uint8_t       jobIndex   = 0;    // posição na listagem
+static uint8_t       jobPart    = 0;    // pedaço da linha em curso
+
+// Imprime um valor de canal: centésimos, exceto a luminosidade (%)
+static void printChannelValue(TextBuf<SERIAL_LINE_SIZE>& line, uint8_t channel, int16_t value) {
+  if (channel == ALERT_CH_LIGHT) line.fixed((int32_t)value, FMT_PERCENT);
+  else                           line.fixed((int32_t)value, FMT_CENTI);
+}
 
-  if (homePageActive) {
-    checkTempAlert();
-    checkHumdAlert();
+static bool stepLog() {
+  TextBuf<SERIAL_LINE_SIZE> line;
+  if (jobPart == 0) {
+    line.text(F("Timestamp\t"));
+    if (logColumns & LOG_CH_TEMP) line.text(F("\tTemperature"));
+    if (logColumns & LOG_CH_HUMD) line.text(F("\tHumidity"));
+    if (logColumns & LOG_CH_LUM)  line.text(F("\tLuminosidade"));
+    Serial.println(line.c_str());
+    jobPart = 1;
+    return true;
   }
+
+  LogSample sample;
+  if (!logJob.next(sample)) return false;
+  line.time(DateTime(sample.timestamp), TIME_ISO);
+  if (logColumns & LOG_CH_TEMP) line.character('\t').fixed((int32_t)sample.temp, FMT_CENTI).text(F("C\t"));
+  if (logColumns & LOG_CH_HUMD) line.character('\t').fixed((int32_t)sample.humd, FMT_CENTI).text(F("%\t"));
+  if (logColumns & LOG_CH_LUM)  line.character('\t').fixed((int32_t)sample.lum, FMT_PERCENT);
+  Serial.println(line.c_str());
+  return true;
 }
 
-// ALERTAS
-void checkTempAlert() {
-  float minTempThreshold = 15.0;
-  float maxTempThreshold = 25.0;
+// Lê o log da EEPROM na janela [from, to]. Com 'channels', imprime só
+// essas colunas (a projeção é feita aqui, em stepLog) e, pelo
+// changedOnly da consulta, só as amostras em que alguma delas mudou.
+void get_log(uint32_t from, uint32_t to, uint8_t channels, uint16_t limit) {
+  LogQuery query;
+  query.from        = from;
+  query.to          = to;
+  query.changedOnly = channels;
+  query.limit       = limit;
+
+  logJob     = LogCursor(query);
+  logColumns = channels ? channels : LOG_CH_ALL;
+  jobPart    = 0;
+  Serial.println(F("Data stored in EEPROM:"));
+  shellStartJob(stepLog);
+}
 
-  switch (temperatureScale) {
-    case 2: // Fahrenheit
-      minTempThreshold = (15.0 * 1.8) + 32;
-      maxTempThreshold = (25.0 * 1.8) + 32;
+// Uma das três linhas de um episódio
+static void printEpisodeLine(const Episode& e, uint8_t part) {
+  static const char names[ALERT_CHANNELS][13] PROGMEM = { "Temperatura", "Umidade", "Luminosidade" };
+  TextBuf<SERIAL_LINE_SIZE> line;
+  switch (part) {
+    case 0:
+      line.text(flashText(names[e.channel])).text(F(": ")).time(DateTime(e.start), TIME_ISO);
+      break;
+    case 1:
+      line.text(F("Duracao: ")).number(e.minutes).text(F(" min"));
+      if (e.state == EPISODE_OPEN) line.text(F(" (em curso)"));
+      if (e.state == EPISODE_CUT)  line.text(F(" (interrompido)"));
       break;
-    case 3: // Kelvin
-      minTempThreshold = 15.0 + 273.15;
-      maxTempThreshold = 25.0 + 273.15;
+    default:
+      line.text(F("Min "));
+      printChannelValue(line, e.channel, e.min);
+      line.text(F(" Max "));
+      printChannelValue(line, e.channel, e.max);
+      line.text(F(" Med "));
+      printChannelValue(line, e.channel, e.mean);
       break;
   }
+  Serial.println(line.c_str());
+}
 
-  if ((lastAvgTemp < minTempThreshold) || (lastAvgTemp > maxTempThreshold)) {
-    digitalWrite(LED_GRE, HIGH);
-    if (!buzzerOn) {
-      tone(BUZZER_PIN, 1000);
-      buzzerOn         = true;
-      buzzerTempReason = true;
+static bool stepEpisodes() {
+  Episode e;
+  while (jobIndex < episodeCount()) {
+    if (!episodeRead(jobIndex, e)) {
+      jobIndex++;
+      continue;
     }
-  }
-  else {
-    digitalWrite(LED_GRE, LOW);
-    if (buzzerTempReason) {
-      buzzerTempReason = false;
-      if (!buzzerHumdReason && !buzzerLightReason) {
-        noTone(BUZZER_PIN);
-        buzzerOn = false;
-      }
+    printEpisodeLine(e, jobPart);
+    if (++jobPart == 3) {
+      jobPart = 0;
+      jobIndex++;
     }
+    return true;
   }
+  return false;
 }
 
-void checkHumdAlert() {
-  if ((lastAvgHumd < 40.0) || (lastAvgHumd > 65.0)) {
-    digitalWrite(LED_RED, HIGH);
-    if (!buzzerOn) {
-      tone(BUZZER_PIN, 1000);
-      buzzerOn = true;
-      buzzerHumdReason = true;
-    }
+// Lista os episódios de anomalia gravados, do mais antigo ao mais novo
+void get_episodes() {
+  jobIndex = 0;
+  jobPart  = 0;
+  Serial.println(F("Anomaly episodes stored in EEPROM:"));
+  shellStartJob(stepEpisodes);
+}
+
+// Um registro do arquivo passa de SERIAL_LINE_SIZE: sai em dois
+// pedaços, a data com a temperatura e depois umidade e luz
+static void printTrendChannel(TextBuf<SERIAL_LINE_SIZE>& line, uint8_t ch) {
+  line.character('\t');
+  printChannelValue(line, ch, trendRow.min[ch]);
+  line.character('/');
+  printChannelValue(line, ch, trendRow.mean[ch]);
+  line.character('/');
+  printChannelValue(line, ch, trendRow.max[ch]);
+}
+
+static bool stepTrend() {
+  TextBuf<SERIAL_LINE_SIZE> line;
+  switch (jobPart) {
+    case 0:
+      Serial.print(F("Inicio\t\t\tTemp min/med/max"));
+      break;
+    case 1:
+      Serial.println(F("\tUmid min/med/max\tLuz min/med/max"));
+      break;
+    case 2:
+      if (!trendJob.next(trendRow)) return false;
+      line.time(DateTime(trendRow.start), TIME_ISO);
+      printTrendChannel(line, ALERT_CH_TEMP);
+      Serial.print(line.c_str());
+      break;
+    default:
+      printTrendChannel(line, ALERT_CH_HUMD);
+      printTrendChannel(line, ALERT_CH_LIGHT);
+      if (trendRow.open) line.text(F("\t(em curso)"));
+      Serial.println(line.c_str());
+      jobPart = 2;
+      return true;
   }
-  else {
-    digitalWrite(LED_RED, LOW);
-    if (buzzerHumdReason) {
-      buzzerHumdReason = false;
-      if (!buzzerTempReason && !buzzerLightReason) {
-        noTone(BUZZER_PIN);
-        buzzerOn = false;
+  jobPart++;
+  return true;
+}
+
+// Lista o arquivo de tendências em [from, to], na resolução mais
+// grossa com no máximo 'step' segundos entre os pontos
+void get_trend(uint32_t from, uint32_t to, uint32_t step) {
+  static const char names[ARCHIVE_TIERS][7] PROGMEM = { "minuto", "hora", "dia" };
+  uint8_t tier = archiveTierFor(step);
+
+  trendJob = ArchiveCursor(tier, from, to);
+  jobPart  = 0;
+  TextBuf<SERIAL_LINE_SIZE> line;
+  line.text(F("Tendencia por ")).text(flashText(names[tier])).text(F(":"));
+  Serial.println(line.c_str());
+  shellStartJob(stepTrend);
+}
+
+#if PROFILE_ENABLED
+// Faixas [first, last) de uma linha do perfil
+static void printBuckets(const ProfileStage* s, uint8_t first, uint8_t last) {
+  TextBuf<SERIAL_LINE_SIZE> line;
+  for (uint8_t b = first; b < last; b++) {
+    line.character('\t');
+    if (s) line.number(s->buckets[b]);
+    else if (b < PROFILE_BUCKETS - 1) line.character('<').number((int32_t)profileBucketLimit(b));
+    else line.text(F("mais"));
+  }
+  Serial.print(line.c_str());
+}
+
+// Linha 0 é o cabeçalho; cada linha sai em três pedaços
+static bool stepProfile() {
+  const uint8_t       half = PROFILE_BUCKETS / 2;
+  const ProfileStage* s    = jobIndex > 0 && jobIndex <= PROF_STAGES ? &profileStage(jobIndex - 1) : NULL;
+  TextBuf<SERIAL_LINE_SIZE> line;
+
+  if (jobIndex > PROF_STAGES) {
+    if (jobIndex > PROF_STAGES + 1) return false;
+    line.text(F("I2C: ")).number((int32_t)profileCounter(PROF_COUNT_I2C));
+    line.text(F(" EEPROM: ")).number((int32_t)profileCounter(PROF_COUNT_EEPROM));
+    line.text(F(" AT24C32: ")).number((int32_t)profileCounter(PROF_COUNT_AT24));
+    Serial.println(line.c_str());
+    jobIndex++;
+    return true;
+  }
+
+  switch (jobPart) {
+    case 0:
+      if (s) {
+        PGM_P name = profileStageName(jobIndex - 1);
+        line.text(flashText(name)).character('\t');
+        if (strlen_P(name) < 8) line.character('\t');
+        line.number((int32_t)s->count);
+        line.character('\t').number((int32_t)s->maxUs);
       }
-    }
+      else {
+        line.text(F("etapa\t\tn\tmax"));
+      }
+      Serial.print(line.c_str());
+      break;
+    case 1:
+      printBuckets(s, 0, half);
+      break;
+    default:
+      printBuckets(s, half, PROFILE_BUCKETS);
+      Serial.println();
+      jobPart = 0;
+      jobIndex++;
+      return true;
   }
+  jobPart++;
+  return true;
 }
 
-void checkLightAlert() {
-  if ((lightLevel < 0) || (lightLevel > 30)) {
-    digitalWrite(LED_YEL, HIGH);
-    if (!buzzerOn) {
-      tone(BUZZER_PIN, 1000);
-      buzzerOn          = true;
-      buzzerLightReason = true;
-    }
+// Histogramas de duração por etapa (profile.h) e contadores de
+// barramento, desde o boot ou o último profileReset()
+void get_profile() {
+  jobIndex = 0;
+  jobPart  = 0;
+  Serial.println(F("Perfil de execucao (contagem por faixa, us):"));
+  shellStartJob(stepProfile);
+}
+#endif
+
+// Tarefas do agendador e contadores dos módulos, uma linha por passo
+static bool stepCounters() {
+  TextBuf<SERIAL_LINE_SIZE> line;
+  int extra = jobIndex - scheduler.count();
+
+  if (jobIndex == 0) {
+    line.text(F("tarefa\t\texec\tperd.\tatras.\tmax us"));
+  }
+  else if (extra <= 0) {
+    const Task& t = scheduler.task(jobIndex - 1);
+    line.text(flashText(t.name)).character('\t');
+    if (strlen_P(t.name) < 8) line.character('\t');
+    line.number((int32_t)t.runs).character('\t').number((int32_t)t.missed);
+    line.character('\t').number((int32_t)t.lateRuns).character('\t').number((int32_t)t.maxUs);
   }
+  else if (extra == 1) {
+    line.text(F("passadas: ")).number((int32_t)scheduler.passes());
+    line.text(F(" pior: ")).number((int32_t)scheduler.maxPassUs()).text(F(" us"));
+  }
+  else if (extra == 2) {
+    line.text(F("relogio: ")).number(clockResyncs()).text(F(" ressinc., "));
+    line.number(clockCorrections()).text(F(" correcoes"));
+  }
+  else if (extra == 3) {
+    line.text(F("log: ")).number(logBlockCount()).text(F(" blocos "));
+    line.text(logTier() == LOG_TIER_EXTERNAL ? F("(AT24C32)") : F("(interna)"));
+    line.text(F(", episodios: ")).number(episodeCount());
+  }
+  else if (extra == 4) {
+    line.text(F("avisos serial perdidos: ")).number(reportQueue.dropped());
+  }
+#if PROFILE_ENABLED
+  else if (extra == 5) {
+    line.text(F("I2C: ")).number((int32_t)profileCounter(PROF_COUNT_I2C));
+    line.text(F(" EEPROM: ")).number((int32_t)profileCounter(PROF_COUNT_EEPROM));
+    line.text(F(" AT24C32: ")).number((int32_t)profileCounter(PROF_COUNT_AT24));
+  }
+#endif
   else {
-    digitalWrite(LED_YEL, LOW);
-    if (buzzerLightReason) {
-      buzzerLightReason = false;
-      if (!buzzerTempReason && !buzzerHumdReason) {
-        noTone(BUZZER_PIN);
-        buzzerOn = false;
-      }
-    }
+    return false;
+  }
+  Serial.println(line.c_str());
+  jobIndex++;
+  return true;
+}
+
+// Regras de alerta em vigor, em unidades de exibição (°C, %)
+static const char ruleNames[ALERT_CHANNELS][5] PROGMEM = { "temp", "umid", "luz" };
+
+static bool stepRules() {
+  if (jobIndex >= alertRuleCount()) return false;
+  const AlertRule& rule = alertRule(jobIndex++);
+  TextBuf<SERIAL_LINE_SIZE> line;
+  line.text(flashText(ruleNames[rule.channel])).text(F(": "));
+  printChannelValue(line, rule.channel, rule.low);
+  line.text(F(" .. "));
+  printChannelValue(line, rule.channel, rule.high);
+  Serial.println(line.c_str());
+  return true;
+}
+
+
+/************************************************************
+ *                   COMANDOS PELA SERIAL                   *
+ ************************************************************/
+// Janela das últimas 'text' horas (ou tudo, sem o argumento)
+static bool parseHours(const char* text, uint32_t& from) {
+  int32_t hours;
+  if (!shellParseFixed(text, 0, hours) || hours <= 0) return false;
+  uint32_t now = clockUnix();
+  from = (uint32_t)hours * 3600UL < now ? now - (uint32_t)hours * 3600UL : 0;
+  return true;
+}
+
+static bool cmdHelp(uint8_t argc, char** argv) {
+  shellHelp();
+  return true;
+}
+
+// Depois das horas e do limite, nomes de canal: só essas colunas, e
+// só as amostras em que alguma delas mudou (LogQuery::changedOnly)
+static bool cmdLog(uint8_t argc, char** argv) {
+  uint32_t from     = 0;
+  int32_t  limit    = 0;
+  uint8_t  channels = 0;
+  if (argc > 1 && !parseHours(argv[1], from)) return false;
+  if (argc > 2 && (!shellParseFixed(argv[2], 0, limit) || limit < 0 || limit > 0xFFFF)) return false;
+  for (uint8_t i = 3; i < argc; i++) {
+    uint8_t channel = 0;
+    while (channel < ALERT_CHANNELS && strcmp_P(argv[i], ruleNames[channel]) != 0) channel++;
+    if (channel == ALERT_CHANNELS) return false;
+    channels |= 1 << channel;          // LOG_CH_* segue a ordem de ALERT_CH_*
   }
+
+  if (!LOG_OPTION) {
+    Serial.println(F("exportacao do log desativada"));
+    return true;
+  }
+  get_log(from, 0xFFFFFFFF, channels, (uint16_t)limit);
+  return true;
+}
+
+static bool cmdEpisodes(uint8_t argc, char** argv) {
+  if (argc > 1) return false;
+  get_episodes();
+  return true;
 }
 
-// Função para avançar o ponteiro na EEPROM
-void getNextAddress() {
-  currentAddress += recordSize;
-  if (currentAddress >= endAddress) {
-    currentAddress = 0;
-  }
-}
-
-// Lê o log da EEPROM
-void get_log() {
-  Serial.println("Data stored in EEPROM:");
-  Serial.println("Timestamp\t\tTemperature\tHumidity\tLuminosidade");
-
-  for (int address = startAddress; address < endAddress; address += recordSize) {
-    long timeStamp;
-    int tempInt, humiInt, lumiInt;
-
-    EEPROM.get(address,     timeStamp);
-    EEPROM.get(address + 4, tempInt);
-    EEPROM.get(address + 6, humiInt);
-    // ===============================
-    // NOVO: Leitura da luminosidade
-    // ===============================
-    EEPROM.get(address + 8, lumiInt);
-
-    float temperature = tempInt / 100.0;
-    float humidity    = humiInt / 100.0;
-    int   luminosity  = lumiInt;
-
-    // 0xFFFFFFFF = valor 'invalido' ou "sem dados"
-    if (timeStamp != 0xFFFFFFFF) {
-      DateTime dt(timeStamp);
-
-      Serial.print(dt.year());
-      Serial.print("-");
-      Serial.print(dt.month() < 10 ? "0" : ""); 
-      Serial.print(dt.month());
-      Serial.print("-");
-      Serial.print(dt.day() < 10 ? "0" : "");
-      Serial.print(dt.day());
-      Serial.print(" ");
-      Serial.print(dt.hour() < 10 ? "0" : "");
-      Serial.print(dt.hour());
-      Serial.print(":");
-      Serial.print(dt.minute() < 10 ? "0" : "");
-      Serial.print(dt.minute());
-      Serial.print(":");
-      Serial.print(dt.second() < 10 ? "0" : "");
-      Serial.print(dt.second());
-
-      Serial.print("\t");
-      Serial.print(temperature); Serial.print("C\t\t");
-      Serial.print(humidity);    Serial.print("%\t\t");
-      Serial.print(luminosity);  Serial.println("%");
+static bool cmdTrend(uint8_t argc, char** argv) {
+  int32_t  step = 3600;
+  uint32_t from = 0;
+  if (argc > 3) return false;
+  if (argc > 1 && (!shellParseFixed(argv[1], 0, step) || step <= 0)) return false;
+  if (argc > 2 && !parseHours(argv[2], from)) return false;
+  get_trend(from, 0xFFFFFFFF, (uint32_t)step);
+  return true;
+}
+
+static bool cmdCounters(uint8_t argc, char** argv) {
+  if (argc > 1) return false;
+  jobIndex = 0;
+  shellStartJob(stepCounters);
+  return true;
+}
+
+#if PROFILE_ENABLED
+static bool cmdProfile(uint8_t argc, char** argv) {
+  if (argc > 2) return false;
+  if (argc == 2) {
+    if (strcmp_P(argv[1], PSTR("zera")) != 0) return false;
+    profileReset();
+    Serial.println(F("perfil zerado"));
+    return true;
+  }
+  get_profile();
+  return true;
+}
+#endif
+
+// limite <temp|umid|luz> <min> <max>, em °C, % e % de luz
+static bool cmdLimit(uint8_t argc, char** argv) {
+  if (argc == 1) {
+    jobIndex = 0;
+    shellStartJob(stepRules);
+    return true;
+  }
+  if (argc != 4) return false;
+
+  uint8_t channel = 0;
+  while (channel < ALERT_CHANNELS && strcmp_P(argv[1], ruleNames[channel]) != 0) channel++;
+  if (channel == ALERT_CHANNELS) return false;
+
+  uint8_t decimals = channel == ALERT_CH_LIGHT ? 0 : 2;
+  int32_t low, high;
+  if (!shellParseFixed(argv[2], decimals, low) || !shellParseFixed(argv[3], decimals, high) ||
+      low >= high || low < -32768 || high > 32767) return false;
+
+  for (uint8_t i = 0; i < alertRuleCount(); i++) {
+    if (alertRule(i).channel != channel) continue;
+    AlertRule rule = alertRule(i);
+    rule.low  = (int16_t)low;
+    rule.high = (int16_t)high;
+    if (!alertSetRule(i, rule)) {
+      Serial.println(F("faixa menor que a histerese"));
+      return true;
     }
+
+    jobIndex = i;
+    stepRules();
+    // A EEPROM interna leva ~3,3 ms por byte: grava aos poucos
+    alertSaveBegin();
+    shellStartJob(alertSaveStep);
+    return true;
   }
+  Serial.println(F("sem regra para o canal"));
+  return true;
+}
+
+static bool cmdScale(uint8_t argc, char** argv) {
+  if (argc != 2 || argv[1][1] != '\0') return false;
+  switch (argv[1][0]) {
+    case 'c': temperatureScale = 1; break;   // Celsius
+    case 'f': temperatureScale = 2; break;   // Fahrenheit
+    case 'k': temperatureScale = 3; break;   // Kelvin
+    default:  return false;
+  }
+  Serial.print(F("escala: "));
+  Serial.println(scaleLetter());
+  return true;
+}
+
+static bool cmdClock(uint8_t argc, char** argv) {
+  if (argc > 1) return false;
+  {
+    PROFILE_SCOPE(PROF_CLOCK);
+    clockResync();
+  }
+  TextBuf<SERIAL_LINE_SIZE> line;
+  line.text(F("hora: ")).time(clockNow(), TIME_ISO);
+  Serial.println(line.c_str());
+  return true;
+}
+
+// Na flash; o nome de cada comando é a primeira palavra do uso
+const ShellCommand shellCommands[] PROGMEM = {
+  { "ajuda",                                 cmdHelp },
+  { "log [horas] [limite] [temp|umid|luz..]", cmdLog },
+  { "episodios",                             cmdEpisodes },
+  { "tendencia [passo_s] [horas]",           cmdTrend },
+  { "contadores",                            cmdCounters },
+#if PROFILE_ENABLED
+  { "perfil [zera]",                         cmdProfile },
+#endif
+  { "limite [temp|umid|luz <min> <max>]",    cmdLimit },
+  { "escala <c|f|k>",                        cmdScale },
+  { "relogio (ressincroniza com o DS3231)",  cmdClock },
+};
+const uint8_t shellCommandCount = sizeof(shellCommands) / sizeof(shellCommands[0]);
+
+// Um episódio abriu, foi atualizado ou fechou: vai para a fila
+static void reportEpisode(uint8_t event, const Episode& e) {
+  SerialReport r;
+  r.kind    = REPORT_EPISODE;
+  r.event   = event;
+  r.episode = e;
+  reportQueue.push(r);
 }
 
 // Registra anomalias na EEPROM
 void recordEEPROM(){
-  now = rtc.now();
-
-  // Offset de fuso
-  int offsetSeconds = UTC_OFFSET * 3600;
-  now = now.unixtime() + offsetSeconds;
-  adjustedTime = DateTime(now);
-
-  // Só registra uma vez por minuto
-  if (adjustedTime.minute() != lastLoggedMinute) {
-    lastLoggedMinute = adjustedTime.minute();
-
-    // Se algum valor está fora do limite
-    if (lastAvgTemp < trigger_t_min || lastAvgTemp > trigger_t_max || 
-        lastAvgHumd < trigger_u_min || lastAvgHumd > trigger_u_max || 
-        lightLevel < trigger_l_min || lightLevel > trigger_l_max) {
-          
-      int tempInt = (int)(lastAvgTemp * 100);
-      int humiInt = (int)(lastAvgHumd * 100);
-      // =========================
-      // NOVO: guarda luminosidade
-      // =========================
-      int lumiInt = lightLevel; 
-
-      EEPROM.put(currentAddress,     now.unixtime()); 
-      EEPROM.put(currentAddress + 4, tempInt);        
-      EEPROM.put(currentAddress + 6, humiInt);        
-      EEPROM.put(currentAddress + 8, lumiInt);        
-
-      // Log no Serial
-      Serial.println("Registro de Anomalia Gravado:");
-      Serial.print("Data/Hora: ");
-      Serial.print(adjustedTime.year());  Serial.print("-");
-      Serial.print(adjustedTime.month() < 10 ? "0" : ""); Serial.print(adjustedTime.month()); Serial.print("-");
-      Serial.print(adjustedTime.day() < 10 ? "0" : "");   Serial.print(adjustedTime.day());   Serial.print(" ");
-      Serial.print(adjustedTime.hour() < 10 ? "0" : "");  Serial.print(adjustedTime.hour());  Serial.print(":");
-      Serial.print(adjustedTime.minute() < 10 ? "0" : "");Serial.print(adjustedTime.minute());Serial.print(":");
-      Serial.print(adjustedTime.second() < 10 ? "0" : "");Serial.println(adjustedTime.second());
-
-      Serial.print("Temperatura: ");  Serial.print(lastAvgTemp);  Serial.println("°C");
-      Serial.print("Umidade: ");      Serial.print(lastAvgHumd);  Serial.println("%");
-      Serial.print("Luminosidade: "); Serial.print(lightLevel);    Serial.println("%");
-      Serial.println("---------------------------------");
-
-      getNextAddress();
+  // Sem médias do DHT11 ainda, não há o que comparar com os triggers
+  if (!avgValid) return;
+
+  // Cada canal fora dos limites vira um episódio (episodes.h): só o
+  // início, o fim e uma atualização por hora vão para a EEPROM
+  uint32_t now    = clockUnix();
+  uint8_t  active = alertActive();
+  int16_t  values[ALERT_CHANNELS];
+  values[ALERT_CH_TEMP]  = lastAvgTemp;
+  values[ALERT_CH_HUMD]  = lastAvgHumd;
+  values[ALERT_CH_LIGHT] = lastAvgLum;
+
+  bool changed = false;
+  for (uint8_t ch = 0; ch < ALERT_CHANNELS; ch++) {
+    uint8_t event = episodeUpdate(ch, active & (1 << ch), values[ch], now);
+    if (event == EPISODE_NONE) continue;
+    reportEpisode(event, episodeCurrent(ch));
+    changed = true;
+  }
+  if (!changed) return;
+  scheduler.startTimer(timerEpisodes, 0);
+
+  // Retrato dos três canais no log de amostras, para o contexto
+  LogSample sample;
+  sample.timestamp = now;
+  sample.temp      = lastAvgTemp;
+  sample.humd      = lastAvgHumd;
+  sample.lum       = lastAvgLum;
+  logAppend(sample);
+
+  if (serialMode == SERIAL_BINARY) {
+    SerialReport r;
+    r.kind   = REPORT_RECORD;
+    r.record = sample;
+    reportQueue.push(r);
+  }
+}
+
+// Tendência normal: as médias de 1 s entram no arquivo, que
+// consolida minutos, horas e dias (archive.h)
+void recordTrend() {
+  if (!avgValid) return;
+
+  int16_t values[ARCHIVE_CHANNELS];
+  values[ALERT_CH_TEMP]  = lastAvgTemp;
+  values[ALERT_CH_HUMD]  = lastAvgHumd;
+  values[ALERT_CH_LIGHT] = lastAvgLum;
+  archiveAdd(clockUnix(), values);
+}
+
+// Log no monitor serial: guarda o retrato da leitura, que substitui
+// o anterior se ele ainda não saiu
+void serialLog(int16_t temp, int16_t humid, int valorLDR, long leituraNum) {
+  TelemetrySample& sample = pendingSample.sample;
+  pendingSample.kind   = REPORT_SAMPLE;
+  pendingSample.number = leituraNum;
+  sample.seq       = (uint8_t)leituraNum;
+  sample.timestamp = clockUnix();
+  sample.temp      = temp;
+  sample.tempAvg   = lastAvgTemp;
+  sample.humd      = humid;
+  sample.humdAvg   = lastAvgHumd;
+  sample.lum       = (int8_t)lightLevel;
+  sample.ldrRaw    = valorLDR;
+  sample.flags     = alertActive() | (alertBuzzerOn() ? TELEMETRY_BUZZER : 0) |
+                     (temperatureScale << TELEMETRY_SCALE_SHIFT);
+  samplePending = true;
+}
+
+// Uma linha da leitura periódica em texto; devolve false na última
+static bool printSampleLine(const SerialReport& r, uint8_t part) {
+  const TelemetrySample& sample = r.sample;
+  char scaleUnit[4] = { '\xC2', '\xB0', scaleLetter(), '\0' };   // "°C" em UTF-8
+  TextBuf<SERIAL_LINE_SIZE> line;
+
+  switch (part) {
+    case 0: line.text(F("Leitura: ")).number(r.number + 1); break;
+    case 1: line.text(F("Temp: ")).fixed(toScale(sample.temp), FMT_CENTI).text(scaleUnit); break;
+    case 2: line.text(F("Ultima Temp Media: ")).fixed(toScale(sample.tempAvg), FMT_CENTI).text(scaleUnit); break;
+    case 3: line.text(F("Umidade: ")).fixed((int32_t)sample.humd, FMT_CENTI).text(F(" %")); break;
+    case 4: line.text(F("Ultima Umidade Media: ")).fixed((int32_t)sample.humdAvg, FMT_CENTI).text(F(" %")); break;
+    case 5: line.text(F("Luminosidade: ")).number(sample.lum).text(F(" %")); break;
+    case 6: line.text(F("ValorLDR: ")).number(sample.ldrRaw); break;
+    case 7: line.time(DateTime(sample.timestamp), TIME_BR); break;
+    default:
+      Serial.println(F("---"));
+      return false;
+  }
+  Serial.println(line.c_str());
+  return true;
+}
+
+// Uma linha do aviso de episódio em texto; devolve false na última
+static bool printEpisodeReport(const SerialReport& r, uint8_t part) {
+  switch (part) {
+    case 0:
+      if (r.event == EPISODE_STARTED)        Serial.println(F("Inicio de Anomalia:"));
+      else if (r.event == EPISODE_HEARTBEAT) Serial.println(F("Anomalia em Curso:"));
+      else                                   Serial.println(F("Fim de Anomalia:"));
+      return true;
+    case 1:
+    case 2:
+    case 3:
+      printEpisodeLine(r.episode, part - 1);
+      return true;
+  }
+  Serial.println(F("---------------------------------"));
+  return false;
+}
+
+// O relatório inteiro num quadro binário
+static void sendReportFrame(const SerialReport& r) {
+  uint8_t payload[TELEMETRY_PAYLOAD_MAX];
+  size_t  len = 0;
+
+  if (r.kind == REPORT_SAMPLE) {
+    len = telemetryPackSample(r.sample, payload);
+  }
+  else if (r.kind == REPORT_EPISODE) {
+    TelemetryEpisode episode;
+    episode.event   = r.event;
+    episode.channel = r.episode.channel;
+    episode.start   = r.episode.start;
+    episode.minutes = r.episode.minutes;
+    episode.min     = r.episode.min;
+    episode.max     = r.episode.max;
+    episode.mean    = r.episode.mean;
+    len = telemetryPackEpisode(episode, payload);
+  }
+  else {
+    TelemetryRecord record;
+    record.timestamp = r.record.timestamp;
+    record.temp      = r.record.temp;
+    record.humd      = r.record.humd;
+    record.lum       = (int8_t)r.record.lum;
+    len = telemetryPackRecord(record, payload);
+  }
+  sendFrame(payload, len);
+}
+
+// Escreve a próxima linha (ou o quadro) do relatório em escrita, ou
+// começa o próximo: os eventos da fila antes da leitura periódica.
+// Quem chama garante SERIAL_OUTPUT_ROOM bytes livres na TX. Devolve
+// false se não havia nada para escrever.
+bool reportStep() {
+  if (report.kind == REPORT_NONE) {
+    if (!reportQueue.pop(report)) {
+      if (!samplePending) return false;
+      report        = pendingSample;
+      samplePending = false;
     }
+    reportLine = 0;
   }
+
+  bool more = false;
+  if (serialMode == SERIAL_BINARY)        sendReportFrame(report);
+  else if (report.kind == REPORT_SAMPLE)  more = printSampleLine(report, reportLine);
+  else if (report.kind == REPORT_EPISODE) more = printEpisodeReport(report, reportLine);
+
+  if (more) reportLine++;
+  else      report.kind = REPORT_NONE;
+  return true;
 }
 
-// Log no monitor serial
-void serialLog(float temp, float humid, int valorLDR, long leituraNum) {
-  now = rtc.now();
+// Leitura do sensor em centésimos, arredondada
+int16_t toCenti(float value) {
+  return (int16_t)(value * 100 + (value < 0 ? -0.5f : 0.5f));
+}
 
-  int offsetSeconds = UTC_OFFSET * 3600;
-  now = now.unixtime() + offsetSeconds;
-  adjustedTime = DateTime(now);
-  
-  String scaleChar = "°C";
-  if (temperatureScale == 2)      scaleChar = "°F";
-  else if (temperatureScale == 3) scaleChar = "°K";
-
-  Serial.println("Leitura: " + String(leituraNum + 1));
-  Serial.println("Temp: " + String(temp) + scaleChar);
-  Serial.println("Ultima Temp Media: " + String(lastAvgTemp) + scaleChar);
-  Serial.println("Umidade: " + String(humid) + " %");
-  Serial.println("Ultima Umidade Media: " + String(lastAvgHumd) + " %");
-  Serial.println("Luminosidade: " + String(lightLevel) + " %");
-  Serial.println("ValorLDR: " + String(valorLDR));
-  
-  Serial.print(adjustedTime.day());
-  Serial.print("/");
-  Serial.print(adjustedTime.month());
-  Serial.print("/");
-  Serial.print(adjustedTime.year());
-  Serial.print(" ");
-  Serial.print(adjustedTime.hour() < 10 ? "0" : "");
-  Serial.print(adjustedTime.hour());
-  Serial.print(":");
-  Serial.print(adjustedTime.minute() < 10 ? "0" : "");
-  Serial.print(adjustedTime.minute());
-  Serial.print(":");
-  Serial.print(adjustedTime.second() < 10 ? "0" : "");
-  Serial.print(adjustedTime.second());
-  Serial.println();
-  Serial.println("---");
+// Centésimos de °C na escala de exibição atual (ainda em centésimos)
+int32_t toScale(int16_t centiCelsius) {
+  switch (temperatureScale) {
+    case 2: return (int32_t)centiCelsius * 9 / 5 + 3200;   // Fahrenheit
+    case 3: return (int32_t)centiCelsius + 27315;          // Kelvin
+  }
+  return centiCelsius;
+}
+
+// Letra da escala de temperatura atual
+char scaleLetter() {
+  if (temperatureScale == 2) return 'F';
+  if (temperatureScale == 3) return 'K';
+  return 'C';
+}
+
+// A serial está ocupada com a exportação ou uma listagem do shell
+bool serialBusy() {
+  return exportActive() || shellBusy();
+}
+
+// Envia um quadro binário (CRC + COBS + delimitador)
+void sendFrame(const uint8_t* payload, size_t len) {
+  uint8_t frame[TELEMETRY_FRAME_MAX];
+  Serial.write(frame, telemetryFrame(payload, len, frame));
 }
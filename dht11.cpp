@@ -0,0 +1,89 @@
+#include "dht11.h"
+
+#include <avr/io.h>
+
+// A ISR não recebe argumentos: aponta para o único sensor
+static Dht11* instance = NULL;
+
+Dht11::Dht11(uint8_t pin)
+  : pin(pin), state(DHT11_IDLE), lastStatus(DHT11_TIMEOUT), ready(false),
+    centiTemp(0), centiHumd(0), failCount(0), edges(0), lastEdgeUs(0) {}
+
+void Dht11::begin() {
+  instance = this;
+  pinMode(pin, INPUT_PULLUP);
+  state = DHT11_IDLE;
+}
+
+uint16_t Dht11::poll() {
+  switch (state) {
+    case DHT11_IDLE:
+      // Pulso de início: a linha fica em LOW até a próxima etapa
+      pinMode(pin, OUTPUT);
+      digitalWrite(pin, LOW);
+      state = DHT11_START;
+      return DHT11_START_MS;
+
+    case DHT11_START:
+      for (uint8_t i = 0; i < 5; i++) data[i] = 0;
+      edges      = 0;
+      lastEdgeUs = micros();
+      // EICRA continua em FALLING desde a leitura anterior, então o
+      // pulso de início deixou o pedido pendente: sem limpá-lo, a ISR
+      // dispararia já no attach com uma borda falsa. Bit n = INTFn.
+      EIFR = _BV(digitalPinToInterrupt(pin));
+      attachInterrupt(digitalPinToInterrupt(pin), isr, FALLING);
+      pinMode(pin, INPUT_PULLUP);
+      state = DHT11_CAPTURE;
+      return DHT11_CAPTURE_MS;
+
+    case DHT11_CAPTURE:
+    default:
+      detachInterrupt(digitalPinToInterrupt(pin));
+      finish();
+      state = DHT11_IDLE;
+      return DHT11_PERIOD_MS - DHT11_START_MS - DHT11_CAPTURE_MS;
+  }
+}
+
+bool Dht11::available() {
+  if (!ready) return false;
+  ready = false;
+  return true;
+}
+
+// Descida 0: início da resposta; descida 1: início do bit 0;
+// descida k (k >= 2): fim do bit k-2. A largura do bit é o
+// intervalo entre a descida que o abre e a que o fecha.
+void Dht11::isr() {
+  Dht11*   self  = instance;
+  uint32_t now   = micros();
+  uint32_t width = now - self->lastEdgeUs;
+  uint8_t  edge  = self->edges;
+
+  self->lastEdgeUs = now;
+  if (edge >= 2 && edge < DHT11_EDGES) {
+    uint8_t i = (edge - 2) >> 3;
+    self->data[i] = (uint8_t)((self->data[i] << 1) | (width > DHT11_ONE_US ? 1 : 0));
+  }
+  if (edge < 255) self->edges = edge + 1;
+}
+
+void Dht11::finish() {
+  // Com a interrupção já desligada, os dados não mudam mais
+  if (edges < DHT11_EDGES) {
+    lastStatus = DHT11_TIMEOUT;
+  }
+  else if ((uint8_t)(data[0] + data[1] + data[2] + data[3]) != data[4]) {
+    lastStatus = DHT11_CHECKSUM;
+  }
+  else {
+    // Parte inteira e décimos; bit 7 dos décimos = temperatura negativa
+    centiHumd = data[0] * 100 + data[1] * 10;
+    centiTemp = data[2] * 100 + (data[3] & 0x7F) * 10;
+    if (data[3] & 0x80) centiTemp = -centiTemp;
+    lastStatus = DHT11_OK;
+  }
+  if (lastStatus != DHT11_OK) failCount++;
+  ready = true;
+}
@@ -0,0 +1,72 @@
+/************************************************************
+ *          DHT11 POR INTERRUPÇÃO (SEM BLOQUEAR)            *
+ ************************************************************/
+// A biblioteca DHT lê os 40 bits do sensor por espera ativa, com as
+// interrupções desligadas por alguns milissegundos. Este driver
+// divide a transação em etapas curtas e captura a resposta pela
+// interrupção externa do pino (INT1 no pino 3 do UNO):
+//
+//   DHT11_IDLE    -> puxa a linha para LOW (pulso de início, >= 18 ms)
+//   DHT11_START   -> solta a linha e liga a interrupção de descida
+//   DHT11_CAPTURE -> a ISR mede o intervalo entre descidas de cada
+//                    bit (50 us + 26..28 us = '0', 50 us + 70 us = '1')
+//   DHT11_IDLE    <- desliga a interrupção, confere o checksum e
+//                    publica o resultado
+//
+// poll() executa a etapa atual e devolve quantos ms esperar até a
+// próxima; o firmware a chama de um temporizador do agendador. O
+// período entre transações respeita o limite de 1 Hz do sensor.
+#ifndef DHT11_H
+#define DHT11_H
+
+#include <Arduino.h>
+
+#define DHT11_START_MS    20      // pulso de início (mínimo 18 ms)
+#define DHT11_CAPTURE_MS  10      // resposta completa leva ~4,5 ms
+#define DHT11_PERIOD_MS   1000    // uma transação por segundo, no máximo
+#define DHT11_ONE_US      100     // intervalo acima disso = bit '1'
+#define DHT11_EDGES       42      // início da resposta + 41 descidas dos bits
+
+// Resultado da última transação
+#define DHT11_OK          0
+#define DHT11_TIMEOUT     1       // faltaram bordas (sensor ausente ou ruído)
+#define DHT11_CHECKSUM    2
+
+#define DHT11_IDLE        0
+#define DHT11_START       1
+#define DHT11_CAPTURE     2
+
+class Dht11 {
+public:
+  Dht11(uint8_t pin);
+
+  void     begin();
+  uint16_t poll();                  // etapa atual; devolve a espera em ms
+
+  // true uma vez por transação concluída (com sucesso ou não)
+  bool     available();
+  uint8_t  status() const      { return lastStatus; }
+  int16_t  temperature() const { return centiTemp; }   // centésimos de °C
+  int16_t  humidity() const    { return centiHumd; }   // centésimos de %
+
+  uint16_t failures() const    { return failCount; }
+
+private:
+  static void isr();
+  void finish();
+
+  uint8_t  pin;
+  uint8_t  state;
+  uint8_t  lastStatus;
+  bool     ready;
+  int16_t  centiTemp;
+  int16_t  centiHumd;
+  uint16_t failCount;
+
+  // Escritos pela ISR
+  volatile uint8_t  edges;
+  volatile uint32_t lastEdgeUs;
+  volatile uint8_t  data[5];
+};
+
+#endif
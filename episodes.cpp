@@ -0,0 +1,241 @@
+#include "episodes.h"
+
+#include <EEPROM.h>
+
+#include "profile.h"
+
+// Acompanhamento de um canal
+struct Tracker {
+  Episode  episode;
+  int8_t   slot;          // posição no anel (-1 = sem episódio aberto)
+  int64_t  sum;
+  uint32_t count;
+  uint32_t flushedAt;     // última gravação do registro aberto
+
+  // Registro a gravar, em partes, por episodesSaveStep()
+  uint8_t  image[EPISODE_SIZE];
+  int8_t   imageSlot;     // posição de destino (-1 = nada pendente)
+  uint8_t  imageNext;     // próximo byte a conferir
+};
+
+static Tracker trackers[ALERT_CHANNELS];
+static uint8_t head  = 0;   // próxima posição a gravar
+static uint8_t used  = 0;   // registros válidos no anel
+
+static int slotAddress(uint8_t slot) {
+  return EPISODE_START_ADDRESS + slot * EPISODE_SIZE;
+}
+
+/************************************************************
+ *                   LEITURA E GRAVAÇÃO                     *
+ ************************************************************/
+static void pack(const Episode& e, uint8_t* out) {
+  out[0]  = (uint8_t)((e.state << 4) | (e.channel & 0x03));
+  out[1]  = (uint8_t)e.start;
+  out[2]  = (uint8_t)(e.start >> 8);
+  out[3]  = (uint8_t)(e.start >> 16);
+  out[4]  = (uint8_t)(e.start >> 24);
+  out[5]  = (uint8_t)e.minutes;
+  out[6]  = (uint8_t)(e.minutes >> 8);
+  out[7]  = (uint8_t)e.min;
+  out[8]  = (uint8_t)((uint16_t)e.min >> 8);
+  out[9]  = (uint8_t)e.max;
+  out[10] = (uint8_t)((uint16_t)e.max >> 8);
+  out[11] = (uint8_t)e.mean;
+  out[12] = (uint8_t)((uint16_t)e.mean >> 8);
+  out[13] = (uint8_t)e.samples;
+  out[14] = (uint8_t)(e.samples >> 8);
+
+  uint8_t crc = 0xFF;
+  for (uint8_t i = 0; i < EPISODE_SIZE - 1; i++) crc = crc8(crc, out[i]);
+  out[EPISODE_SIZE - 1] = crc;
+}
+
+// Registro ainda pendente na RAM para a posição, ou NULL
+static const uint8_t* stagedImage(uint8_t slot) {
+  for (uint8_t ch = 0; ch < ALERT_CHANNELS; ch++) {
+    if (trackers[ch].imageSlot == (int8_t)slot) return trackers[ch].image;
+  }
+  return NULL;
+}
+
+// A leitura vê o registro pendente no lugar do que está na EEPROM
+static bool load(uint8_t slot, Episode& e) {
+  uint8_t        raw[EPISODE_SIZE];
+  const uint8_t* staged  = stagedImage(slot);
+  int            address = slotAddress(slot);
+  uint8_t        crc     = 0xFF;
+  for (uint8_t i = 0; i < EPISODE_SIZE; i++) {
+    raw[i] = staged ? staged[i] : EEPROM.read(address + i);
+    if (i < EPISODE_SIZE - 1) crc = crc8(crc, raw[i]);
+  }
+  if (raw[0] == LOG_ERASED || crc != raw[EPISODE_SIZE - 1]) return false;
+
+  e.state   = raw[0] >> 4;
+  e.channel = raw[0] & 0x03;
+  e.start   = raw[1] | ((uint32_t)raw[2] << 8) | ((uint32_t)raw[3] << 16) | ((uint32_t)raw[4] << 24);
+  e.minutes = (uint16_t)(raw[5] | (raw[6] << 8));
+  e.min     = (int16_t)(raw[7] | (raw[8] << 8));
+  e.max     = (int16_t)(raw[9] | (raw[10] << 8));
+  e.mean    = (int16_t)(raw[11] | (raw[12] << 8));
+  e.samples = (uint16_t)(raw[13] | (raw[14] << 8));
+  return true;
+}
+
+// Grava já o que falta do registro pendente do canal
+static void flushImage(Tracker& t) {
+  while (t.imageSlot >= 0 && t.imageNext < EPISODE_SIZE) {
+    profileEepromUpdate(slotAddress((uint8_t)t.imageSlot) + t.imageNext, t.image[t.imageNext]);
+    t.imageNext++;
+  }
+  t.imageSlot = -1;
+}
+
+// Monta o registro na RAM; quem grava é episodesSaveStep(). Um
+// registro anterior do canal em outra posição (fechou e reabriu antes
+// de terminar a gravação) é completado antes, de uma vez.
+static void store(Tracker& t, uint8_t slot) {
+  if (t.imageSlot >= 0 && t.imageSlot != (int8_t)slot) flushImage(t);
+  pack(t.episode, t.image);
+  t.imageSlot = (int8_t)slot;
+  t.imageNext = 0;
+}
+
+bool episodesSaveStep() {
+  for (uint8_t ch = 0; ch < ALERT_CHANNELS; ch++) {
+    Tracker& t = trackers[ch];
+    while (t.imageSlot >= 0) {
+      if (t.imageNext >= EPISODE_SIZE) {
+        t.imageSlot = -1;
+        break;
+      }
+      int     address = slotAddress((uint8_t)t.imageSlot) + t.imageNext;
+      uint8_t value   = t.image[t.imageNext++];
+      if (EEPROM.read(address) == value) continue;
+      profileEepromUpdate(address, value);
+      return true;
+    }
+  }
+  return false;
+}
+
+void episodesFlush() {
+  for (uint8_t ch = 0; ch < ALERT_CHANNELS; ch++) flushImage(trackers[ch]);
+}
+
+void episodesBegin() {
+  for (uint8_t ch = 0; ch < ALERT_CHANNELS; ch++) {
+    trackers[ch].slot          = -1;
+    trackers[ch].imageSlot     = -1;
+    trackers[ch].episode.state = 0;
+  }
+
+  // Cabeça = logo depois do registro válido com o início mais recente.
+  // Um episódio ainda aberto foi cortado por um reset: ninguém mais o
+  // atualiza, então ele fecha aqui com a duração da última gravação.
+  Episode  e;
+  uint8_t  raw[EPISODE_SIZE];
+  uint32_t newest = 0;
+  head = 0;
+  used = 0;
+  for (uint8_t slot = 0; slot < EPISODE_COUNT; slot++) {
+    if (!load(slot, e)) continue;
+    used++;
+    if (used == 1 || e.start >= newest) {
+      newest = e.start;
+      head   = (slot + 1) % EPISODE_COUNT;
+    }
+    if (e.state == EPISODE_OPEN) {
+      e.state = EPISODE_CUT;
+      pack(e, raw);
+      int address = slotAddress(slot);
+      for (uint8_t i = 0; i < EPISODE_SIZE; i++) profileEepromUpdate(address + i, raw[i]);
+    }
+  }
+}
+
+uint8_t episodeCount() {
+  return used;
+}
+
+bool episodeRead(uint8_t index, Episode& out) {
+  if (index >= used) return false;
+  uint8_t slot = (uint8_t)((head + EPISODE_COUNT - used + index) % EPISODE_COUNT);
+  return load(slot, out);
+}
+
+const Episode& episodeCurrent(uint8_t channel) {
+  return trackers[channel].episode;
+}
+
+/************************************************************
+ *                     ACOMPANHAMENTO                       *
+ ************************************************************/
+// Próxima posição do anel para um episódio novo. As posições de
+// episódios ainda abertos de outros canais, e as que ainda têm
+// registro pendente na RAM, são puladas: o registro aberto continua
+// sendo regravado até fechar, então sobrescrevê-lo perderia o mais
+// novo. Cada canal prende no máximo uma posição, então sempre sobra
+// alguma; o aberto fica onde está, fora da ordem.
+static bool slotHeld(uint8_t slot) {
+  for (uint8_t ch = 0; ch < ALERT_CHANNELS; ch++) {
+    if (trackers[ch].slot == (int8_t)slot || trackers[ch].imageSlot == (int8_t)slot) return true;
+  }
+  return false;
+}
+
+static uint8_t takeSlot() {
+  uint8_t slot = head;
+  while (slotHeld(slot)) slot = (slot + 1) % EPISODE_COUNT;
+  head = (slot + 1) % EPISODE_COUNT;
+  if (used < EPISODE_COUNT) used++;
+  return slot;
+}
+
+static void summarize(Tracker& t, uint32_t now) {
+  t.episode.minutes = (uint16_t)((now - t.episode.start) / 60);
+  t.episode.mean    = (int16_t)(t.sum / (int32_t)t.count);
+  t.episode.samples = t.count > 0xFFFF ? 0xFFFF : (uint16_t)t.count;
+  t.flushedAt       = now;
+}
+
+uint8_t episodeUpdate(uint8_t channel, bool active, int16_t value, uint32_t now) {
+  Tracker& t = trackers[channel];
+
+  if (t.slot < 0) {
+    if (!active) return EPISODE_NONE;
+
+    // Início: grava já o registro aberto
+    t.episode.state   = EPISODE_OPEN;
+    t.episode.channel = channel;
+    t.episode.start   = now;
+    t.episode.min     = value;
+    t.episode.max     = value;
+    t.sum             = value;
+    t.count           = 1;
+    summarize(t, now);
+
+    t.slot = (int8_t)takeSlot();
+    store(t, (uint8_t)t.slot);
+    return EPISODE_STARTED;
+  }
+
+  if (active) {
+    if (value < t.episode.min) t.episode.min = value;
+    if (value > t.episode.max) t.episode.max = value;
+    t.sum += value;
+    t.count++;
+
+    if (now - t.flushedAt < (uint32_t)EPISODE_HEARTBEAT_MIN * 60) return EPISODE_NONE;
+    summarize(t, now);
+    store(t, (uint8_t)t.slot);
+    return EPISODE_HEARTBEAT;
+  }
+
+  // Fim: fecha o registro com o resumo final
+  t.episode.state = EPISODE_CLOSED;
+  summarize(t, now);
+  store(t, (uint8_t)t.slot);
+  t.slot = -1;
+  return EPISODE_ENDED;
+}
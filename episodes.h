@@ -0,0 +1,92 @@
+/************************************************************
+ *            EPISÓDIOS DE ANOMALIA NA EEPROM               *
+ ************************************************************/
+// Em vez de gravar uma amostra por minuto enquanto um valor está
+// fora dos limites, cada excursão de um canal vira um episódio: um
+// registro de EPISODE_SIZE bytes aberto quando a regra de alerta do
+// canal dispara e fechado quando ela volta ao normal, com duração,
+// mínimo, máximo e média do canal durante o episódio:
+//
+//   [estado|canal][início u32][minutos u16][mín i16][máx i16]
+//   [média i16][amostras u16][crc8]
+//
+// byte 0: bits 0-1 = canal (ALERT_CH_*), bits 4-5 = estado
+// (EPISODE_OPEN / EPISODE_CLOSED); 0xFF = posição apagada.
+//
+// O registro aberto é gravado no início (sobrevive a uma queda de
+// energia) e, em episódios longos, atualizado a cada
+// EPISODE_HEARTBEAT_MIN minutos com as estatísticas parciais. O
+// fechamento regrava só os bytes que mudaram (EEPROM.update).
+//
+// episodeUpdate() só monta o registro na RAM: a EEPROM interna leva
+// ~3,3 ms por byte, e os 16 bytes de uma vez travariam o agendador
+// por ~53 ms. Quem grava é episodesSaveStep(), um byte por chamada,
+// e a leitura já vê o registro pendente. Um episódio que o boot
+// encontra aberto foi cortado por um reset e vira EPISODE_CUT.
+//
+// Os registros ficam num anel logo depois do log de amostras; no
+// boot, a cabeça é o registro válido com o início mais recente. Um
+// episódio novo nunca reusa a posição de outro ainda aberto: ela é
+// pulada, e o aberto aparece na leitura fora da ordem de início.
+#ifndef EPISODES_H
+#define EPISODES_H
+
+#include <Arduino.h>
+
+#include "logstore.h"
+#include "alerts.h"
+
+#define EPISODE_START_ADDRESS  LOG_INTERNAL_END
+#define EPISODE_SIZE           16
+#define EPISODE_COUNT          14     // 224 bytes
+#define EPISODE_HEARTBEAT_MIN  60
+
+#if EPISODE_START_ADDRESS + EPISODE_COUNT * EPISODE_SIZE > ALERT_CONFIG_ADDRESS
+#error "episódios invadem o bloco de configuração dos alertas"
+#endif
+
+// Estado gravado
+#define EPISODE_OPEN           1      // em curso
+#define EPISODE_CLOSED         2
+#define EPISODE_CUT            3      // interrompido por um reset (duração até a última gravação)
+
+// Eventos devolvidos por episodeUpdate()
+#define EPISODE_NONE           0
+#define EPISODE_STARTED        1
+#define EPISODE_HEARTBEAT      2
+#define EPISODE_ENDED          3
+
+struct Episode {
+  uint8_t  state;
+  uint8_t  channel;
+  uint32_t start;        // hora local do início
+  uint16_t minutes;      // duração até a última gravação
+  int16_t  min;
+  int16_t  max;
+  int16_t  mean;
+  uint16_t samples;      // leituras somadas (satura em 65535)
+};
+
+// Acha a cabeça do anel e fecha os episódios cortados por um reset
+void    episodesBegin();
+
+// Gravação em partes: cada episodesSaveStep() grava no máximo um byte
+// que mudou; devolve false quando não há mais nada pendente.
+// episodesFlush() grava tudo de uma vez.
+bool    episodesSaveStep();
+void    episodesFlush();
+
+// Uma leitura por canal (normalmente por segundo): 'active' é o
+// estado da regra de alerta do canal. Abre, atualiza e fecha o
+// episódio do canal e devolve o que mudou (EPISODE_*); o registro
+// fica pendente para episodesSaveStep().
+uint8_t episodeUpdate(uint8_t channel, bool active, int16_t value, uint32_t now);
+
+// Episódio em curso (ou o último fechado) do canal
+const Episode& episodeCurrent(uint8_t channel);
+
+// Leitura do anel, do mais antigo (0) ao mais novo
+uint8_t episodeCount();
+bool    episodeRead(uint8_t index, Episode& out);
+
+#endif
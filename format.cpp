@@ -0,0 +1,120 @@
+#include "format.h"
+
+const TimeFormat TIME_ISO      PROGMEM = { TIME_DATE | TIME_CLOCK, TIME_YMD, '-' };
+const TimeFormat TIME_BR       PROGMEM = { TIME_DATE | TIME_CLOCK, TIME_DMY, '/' };
+const TimeFormat TIME_BR_DATE  PROGMEM = { TIME_DATE, TIME_DMY, '/' };
+const TimeFormat TIME_HMS      PROGMEM = { TIME_CLOCK, TIME_DMY, '/' };
+
+const FixedFormat FMT_CENTI    PROGMEM = { 2, 2, '\0' };
+const FixedFormat FMT_CENTI_0  PROGMEM = { 2, 0, '\0' };
+const FixedFormat FMT_PERCENT  PROGMEM = { 0, 0, '%' };
+
+static const uint32_t POW10[] PROGMEM = { 1, 10, 100, 1000, 10000, 100000 };
+
+static uint32_t pow10(uint8_t exponent) {
+  return pgm_read_dword(&POW10[exponent]);
+}
+
+TextBuffer::TextBuffer(char* storage, uint8_t capacity)
+  : data(storage), capacity(capacity), len(0) {
+  data[0] = '\0';
+}
+
+void TextBuffer::clear() {
+  len     = 0;
+  data[0] = '\0';
+}
+
+TextBuffer& TextBuffer::character(char c) {
+  if (len + 1 < capacity) {
+    data[len++] = c;
+    data[len]   = '\0';
+  }
+  return *this;
+}
+
+TextBuffer& TextBuffer::text(const char* str) {
+  while (*str) character(*str++);
+  return *this;
+}
+
+TextBuffer& TextBuffer::text(FlashText str) {
+  PGM_P p = reinterpret_cast<PGM_P>(str);
+  char  c;
+  while ((c = (char)pgm_read_byte(p++)) != '\0') character(c);
+  return *this;
+}
+
+TextBuffer& TextBuffer::number(int32_t value, uint8_t width, char pad) {
+  char     digits[11];
+  uint8_t  count = 0;
+  uint32_t magnitude = value < 0 ? -(uint32_t)value : (uint32_t)value;
+
+  do {
+    digits[count++] = (char)('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude > 0);
+
+  uint8_t total = count + (value < 0 ? 1 : 0);
+  // Com zeros, o sinal vem antes do preenchimento
+  if (value < 0 && pad == '0') character('-');
+  while (total < width) { character(pad); total++; }
+  if (value < 0 && pad != '0') character('-');
+
+  while (count > 0) character(digits[--count]);
+  return *this;
+}
+
+TextBuffer& TextBuffer::twoDigits(uint8_t value) {
+  return number(value, 2, '0');
+}
+
+TextBuffer& TextBuffer::fixed(int32_t value, const FixedFormat& descriptor) {
+  FixedFormat format   = assetRead(&descriptor);
+  uint8_t     drop     = format.scale > format.decimals ? format.scale - format.decimals : 0;
+  uint32_t    divisor  = pow10(drop);
+  uint32_t    rounded  = ((value < 0 ? -(uint32_t)value : (uint32_t)value) + divisor / 2) / divisor;
+  uint32_t    fraction = pow10(format.decimals);
+
+  if (value < 0 && rounded > 0) character('-');
+  number((int32_t)(rounded / fraction));
+  if (format.decimals > 0) {
+    character('.');
+    number((int32_t)(rounded % fraction), format.decimals, '0');
+  }
+  if (format.suffix) character(format.suffix);
+  return *this;
+}
+
+TextBuffer& TextBuffer::fixed(float value, const FixedFormat& descriptor) {
+  float scaled = value * pow10(pgm_read_byte(&descriptor.scale));
+  return fixed((int32_t)(scaled < 0 ? scaled - 0.5f : scaled + 0.5f), descriptor);
+}
+
+TextBuffer& TextBuffer::time(const DateTime& dt, const TimeFormat& descriptor) {
+  TimeFormat format = assetRead(&descriptor);
+  if (format.parts & TIME_DATE) {
+    if (format.order == TIME_YMD) {
+      number(dt.year()).character(format.dateSep);
+      twoDigits(dt.month()).character(format.dateSep);
+      twoDigits(dt.day());
+    }
+    else {
+      twoDigits(dt.day()).character(format.dateSep);
+      twoDigits(dt.month()).character(format.dateSep);
+      number(dt.year());
+    }
+    if (format.parts & TIME_CLOCK) character(' ');
+  }
+  if (format.parts & TIME_CLOCK) {
+    twoDigits(dt.hour()).character(':');
+    twoDigits(dt.minute()).character(':');
+    twoDigits(dt.second());
+  }
+  return *this;
+}
+
+TextBuffer& TextBuffer::padTo(uint8_t column) {
+  while (len < column && len + 1 < capacity) character(' ');
+  return *this;
+}
@@ -0,0 +1,87 @@
+/************************************************************
+ *            FORMATAÇÃO DE TEXTO SEM ALOCAÇÃO              *
+ ************************************************************/
+// Monta texto num buffer de tamanho fixo, normalmente na pilha de
+// quem chama, sem String e sem heap. Todas as saídas de texto (LCD,
+// serial e listagem do log) passam por aqui, com o mesmo
+// preenchimento de dois dígitos e as mesmas casas decimais.
+//
+// Os formatos são descritores constantes (TimeFormat, FixedFormat)
+// declarados abaixo e guardados na flash (assets.h); quem chama
+// escolhe um deles em vez de repetir a lógica de "0" à esquerda. Se
+// o texto não couber, ele é truncado e o buffer continua terminado
+// em '\0'.
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include <Arduino.h>
+#include <RTClib.h>
+
+#include "assets.h"
+
+// Partes e ordem de um timestamp
+#define TIME_DATE   0x01
+#define TIME_CLOCK  0x02
+#define TIME_YMD    0        // 2025-03-20
+#define TIME_DMY    1        // 20/03/2025
+
+struct TimeFormat {
+  uint8_t parts;             // TIME_DATE e/ou TIME_CLOCK
+  uint8_t order;             // TIME_YMD ou TIME_DMY
+  char    dateSep;
+};
+
+extern const TimeFormat TIME_ISO      PROGMEM;   // 2025-03-20 16:39:00
+extern const TimeFormat TIME_BR       PROGMEM;   // 20/03/2025 16:39:00
+extern const TimeFormat TIME_BR_DATE  PROGMEM;   // 20/03/2025
+extern const TimeFormat TIME_HMS      PROGMEM;   // 16:39:00
+
+// Número em ponto fixo: 'value' está em unidades de 10^-scale e é
+// impresso com 'decimals' casas (arredondado), seguido de 'suffix'.
+struct FixedFormat {
+  uint8_t scale;
+  uint8_t decimals;
+  char    suffix;            // '\0' = sem unidade
+};
+
+extern const FixedFormat FMT_CENTI    PROGMEM;   // 23.45 (como Serial.print)
+extern const FixedFormat FMT_CENTI_0  PROGMEM;   // 23
+extern const FixedFormat FMT_PERCENT  PROGMEM;   // 12%
+
+class TextBuffer {
+public:
+  TextBuffer(char* storage, uint8_t capacity);
+
+  void clear();
+
+  TextBuffer& text(const char* str);
+  TextBuffer& text(FlashText str);
+  TextBuffer& character(char c);
+  TextBuffer& number(int32_t value, uint8_t width = 0, char pad = ' ');
+  TextBuffer& twoDigits(uint8_t value);
+  // Os formatos são os descritores em PROGMEM declarados acima
+  TextBuffer& fixed(int32_t value, const FixedFormat& format);
+  TextBuffer& fixed(float value, const FixedFormat& format);
+  TextBuffer& time(const DateTime& dt, const TimeFormat& format);
+  TextBuffer& padTo(uint8_t column);    // espaços até a coluna
+
+  const char* c_str() const  { return data; }
+  uint8_t     length() const { return len; }
+
+private:
+  char*   data;
+  uint8_t capacity;
+  uint8_t len;
+};
+
+// Buffer com armazenamento próprio: TextBuf<17> linha;
+template <uint8_t N>
+class TextBuf : public TextBuffer {
+public:
+  TextBuf() : TextBuffer(storage, N) {}
+
+private:
+  char storage[N];
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "glyphs.h"
+
+#include "profile.h"
+
+/************************************************************
+ *                         DESENHOS                         *
+ ************************************************************/
+const uint8_t GLYPH_THERMOMETER[8] PROGMEM = { B01110, B01010, B01010, B01010, B11111, B11111, B11111, B01110 };
+const uint8_t GLYPH_LIGHTNING[8]   PROGMEM = { B00001, B00010, B00100, B01000, B11111, B00010, B00100, B01000 };
+const uint8_t GLYPH_DROP[8]        PROGMEM = { B00100, B00100, B01110, B01110, B11111, B11111, B11111, B01110 };
+
+const uint8_t GLYPH_HAT_LEFT[8]    PROGMEM = { B00000, B00000, B00000, B00000, B00000, B00000, B00000, B00001 };
+const uint8_t GLYPH_HAT[8]         PROGMEM = { B00000, B01000, B10100, B00100, B01110, B01110, B11111, B11111 };
+const uint8_t GLYPH_HAT_RIGHT[8]   PROGMEM = { B00000, B00000, B00000, B00000, B00000, B00000, B00000, B10000 };
+const uint8_t GLYPH_ROBE[8]        PROGMEM = { B00000, B00000, B00001, B00010, B00010, B00010, B00010, B00010 };
+const uint8_t GLYPH_FACE[8]        PROGMEM = { B10001, B11011, B10001, B01010, B00100, B00000, B00100, B00100 };
+const uint8_t GLYPH_WAND_UP[8]     PROGMEM = { B00010, B00101, B10010, B01010, B01010, B01110, B01010, B01000 };
+const uint8_t GLYPH_WAND_DOWN[8]   PROGMEM = { B00000, B00000, B10000, B01000, B01001, B01110, B01010, B01000 };
+const uint8_t GLYPH_SPARK[8]       PROGMEM = { B00100, B01010, B01100, B10000, B00000, B00000, B00000, B00000 };
+const uint8_t GLYPH_BALL[8]        PROGMEM = { B00100, B01110, B00100, B00000, B00000, B00000, B00000, B00000 };
+
+/************************************************************
+ *                          CACHE                           *
+ ************************************************************/
+GlyphCache::GlyphCache(LiquidCrystal_I2C& device)
+  : device(device), useClock(0), uploadCount(0) {
+  invalidate();
+}
+
+void GlyphCache::invalidate() {
+  for (uint8_t i = 0; i < GLYPH_SLOTS; i++) {
+    resident[i] = NULL;
+    lastUse[i]  = 0;
+  }
+}
+
+uint8_t GlyphCache::slot(const uint8_t* glyph) {
+  useClock++;
+
+  uint8_t victim = 0;
+  for (uint8_t i = 0; i < GLYPH_SLOTS; i++) {
+    if (resident[i] == glyph) {
+      lastUse[i] = useClock;
+      return i;
+    }
+    // Posições vazias primeiro; depois a de uso mais antigo.
+    // A diferença sem sinal continua certa quando o relógio dá a volta.
+    if (resident[victim] != NULL &&
+        (resident[i] == NULL ||
+         (uint16_t)(useClock - lastUse[i]) > (uint16_t)(useClock - lastUse[victim]))) {
+      victim = i;
+    }
+  }
+
+  // createChar() lê da RAM (e não aceita ponteiro para const)
+  uint8_t bitmap[8];
+  memcpy_P(bitmap, glyph, sizeof(bitmap));
+  device.createChar(victim, bitmap);
+  PROFILE_COUNT(PROF_COUNT_I2C, 9 * PROFILE_LCD_I2C_PER_BYTE);   // comando + 8 linhas
+  uploadCount++;
+
+  resident[victim] = glyph;
+  lastUse[victim]  = useClock;
+  return victim;
+}
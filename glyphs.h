@@ -0,0 +1,57 @@
+/************************************************************
+ *          CARACTERES CUSTOMIZADOS (CACHE DA CGRAM)        *
+ ************************************************************/
+// O HD44780 só tem 8 posições de CGRAM. Em vez de cada tela enviar
+// seus desenhos com createChar() toda vez que é exibida, as telas
+// pedem a posição de um glifo a GlyphCache::slot(): se ele já está
+// na CGRAM, nada é enviado; senão ocupa a posição usada há mais
+// tempo (LRU). Os desenhos ficam na flash (PROGMEM) e o glifo é
+// identificado pelo endereço do seu bitmap.
+//
+// Trocar um glifo muda na hora todas as células da tela que mostram
+// aquela posição, por isso uma tela não deve usar mais de 8 glifos.
+#ifndef GLYPHS_H
+#define GLYPHS_H
+
+#include <Arduino.h>
+#include <LiquidCrystal_I2C.h>
+
+#define GLYPH_SLOTS 8
+
+// ==== ÍCONES DA HOME ====
+extern const uint8_t GLYPH_THERMOMETER[8] PROGMEM;
+extern const uint8_t GLYPH_LIGHTNING[8] PROGMEM;
+extern const uint8_t GLYPH_DROP[8] PROGMEM;
+
+// ==== MAGO DA ANIMAÇÃO DE ABERTURA ====
+extern const uint8_t GLYPH_HAT_LEFT[8] PROGMEM;
+extern const uint8_t GLYPH_HAT[8] PROGMEM;
+extern const uint8_t GLYPH_HAT_RIGHT[8] PROGMEM;
+extern const uint8_t GLYPH_ROBE[8] PROGMEM;
+extern const uint8_t GLYPH_FACE[8] PROGMEM;
+extern const uint8_t GLYPH_WAND_UP[8] PROGMEM;
+extern const uint8_t GLYPH_WAND_DOWN[8] PROGMEM;
+extern const uint8_t GLYPH_SPARK[8] PROGMEM;
+extern const uint8_t GLYPH_BALL[8] PROGMEM;
+
+class GlyphCache {
+public:
+  GlyphCache(LiquidCrystal_I2C& device);
+
+  // Posição da CGRAM (0..7) com o glifo (GLYPH_*, em PROGMEM),
+  // enviando-o só se faltar
+  uint8_t slot(const uint8_t* glyph);
+  // Esquece o conteúdo da CGRAM (após reinicializar o LCD)
+  void    invalidate();
+
+  unsigned long uploads() const { return uploadCount; }
+
+private:
+  LiquidCrystal_I2C& device;
+  const uint8_t* resident[GLYPH_SLOTS];   // glifo em cada posição
+  uint16_t       lastUse[GLYPH_SLOTS];    // instante do último uso
+  uint16_t       useClock;
+  unsigned long  uploadCount;
+};
+
+#endif
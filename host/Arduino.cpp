@@ -0,0 +1,292 @@
+#include "Arduino.h"
+
+#include <stdio.h>
+
+#include "sim.h"
+
+// Tempo de conversão do ADC do ATmega328P (13 ciclos a 125 kHz)
+#define ADC_CONVERSION_US 112
+// Buffers da HardwareSerial do núcleo AVR
+#define SERIAL_TX_BUFFER  64
+#define SERIAL_RX_BUFFER  64
+
+HardwareSerial Serial;
+
+/************************************************************
+ *                     TEMPO E PINOS                        *
+ ************************************************************/
+unsigned long millis() {
+  return (unsigned long)(simMicros() / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)simMicros();
+}
+
+void delay(unsigned long ms) {
+  simAdvanceMicros((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+  simAdvanceMicros(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  simSetPinMode(pin, mode);
+}
+
+int digitalRead(uint8_t pin) {
+  return simPinLevel(pin);
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+  simSetPinLevel(pin, level ? HIGH : LOW);
+}
+
+int analogRead(uint8_t pin) {
+  simStats.adcReads++;
+  simAdvanceMicros(ADC_CONVERSION_US);
+  if (pin == A0) return simLightRaw();
+  return 0;
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+  (void)pin;
+  (void)duration;
+  simSetTone(frequency);
+}
+
+void noTone(uint8_t pin) {
+  (void)pin;
+  simSetTone(0);
+}
+
+long map(long value, long fromLow, long fromHigh, long toLow, long toHigh) {
+  return (value - fromLow) * (toHigh - toLow) / (fromHigh - fromLow) + toLow;
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*isr)(void), int mode) {
+  if (interruptNum > 1) return;
+  simAttachInterrupt(interruptNum == 0 ? 2 : 3, isr, mode);
+}
+
+void detachInterrupt(uint8_t interruptNum) {
+  if (interruptNum > 1) return;
+  simDetachInterrupt(interruptNum == 0 ? 2 : 3);
+}
+
+/************************************************************
+ *                         STRING                           *
+ ************************************************************/
+static std::string formatInteger(unsigned long value, unsigned char base, bool negative) {
+  if (base < 2) base = 10;
+  char digits[72];
+  int  pos = sizeof(digits) - 1;
+  digits[pos] = '\0';
+  do {
+    int d = value % base;
+    digits[--pos] = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+    value /= base;
+  } while (value > 0);
+  if (negative) digits[--pos] = '-';
+  return std::string(&digits[pos]);
+}
+
+static std::string formatFloat(double value, unsigned char decimals) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", (int)decimals, value);
+  return std::string(buf);
+}
+
+String::String(int value, unsigned char base)
+  : buffer(base == 10 ? formatInteger(value < 0 ? -(long)value : value, base, value < 0)
+                      : formatInteger((unsigned int)value, base, false)) {}
+
+String::String(unsigned int value, unsigned char base)
+  : buffer(formatInteger(value, base, false)) {}
+
+String::String(long value, unsigned char base)
+  : buffer(base == 10 ? formatInteger(value < 0 ? -(unsigned long)value : value, base, value < 0)
+                      : formatInteger((unsigned long)value, base, false)) {}
+
+String::String(unsigned long value, unsigned char base)
+  : buffer(formatInteger(value, base, false)) {}
+
+String::String(float value, unsigned char decimalPlaces)
+  : buffer(formatFloat(value, decimalPlaces)) {}
+
+String::String(double value, unsigned char decimalPlaces)
+  : buffer(formatFloat(value, decimalPlaces)) {}
+
+String operator+(const String& lhs, const String& rhs) {
+  String result(lhs);
+  result += rhs;
+  return result;
+}
+
+String operator+(const String& lhs, const char* rhs) {
+  String result(lhs);
+  result += rhs;
+  return result;
+}
+
+String operator+(const char* lhs, const String& rhs) {
+  String result(lhs);
+  result += rhs;
+  return result;
+}
+
+String operator+(const String& lhs, char rhs) {
+  String result(lhs);
+  result += rhs;
+  return result;
+}
+
+/************************************************************
+ *                          PRINT                           *
+ ************************************************************/
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) n += write(*buffer++);
+  return n;
+}
+
+size_t Print::printNumber(unsigned long value, int base) {
+  return write(formatInteger(value, (unsigned char)base, false).c_str());
+}
+
+size_t Print::printSigned(long value, int base) {
+  if (base == 10 && value < 0) {
+    return write(formatInteger(-(unsigned long)value, 10, true).c_str());
+  }
+  return printNumber((unsigned long)value, base);
+}
+
+size_t Print::print(const __FlashStringHelper* str) { return write(reinterpret_cast<const char*>(str)); }
+size_t Print::print(const String& str)              { return write(str.c_str()); }
+size_t Print::print(const char str[])               { return write(str); }
+size_t Print::print(char c)                         { return write((uint8_t)c); }
+size_t Print::print(unsigned char value, int base)  { return printNumber(value, base); }
+size_t Print::print(int value, int base)            { return printSigned(value, base); }
+size_t Print::print(unsigned int value, int base)   { return printNumber(value, base); }
+size_t Print::print(long value, int base)           { return printSigned(value, base); }
+size_t Print::print(unsigned long value, int base)  { return printNumber(value, base); }
+
+size_t Print::print(double value, int digits) {
+  if (isnan(value)) return write("nan");
+  if (isinf(value)) return write("inf");
+  return write(formatFloat(value, (unsigned char)digits).c_str());
+}
+
+size_t Print::println()                               { return write("\r\n"); }
+size_t Print::println(const __FlashStringHelper* str) { return print(str) + println(); }
+size_t Print::println(const String& str)              { return print(str) + println(); }
+size_t Print::println(const char str[])               { return print(str) + println(); }
+size_t Print::println(char c)                         { return print(c) + println(); }
+size_t Print::println(unsigned char value, int base)  { return print(value, base) + println(); }
+size_t Print::println(int value, int base)            { return print(value, base) + println(); }
+size_t Print::println(unsigned int value, int base)   { return print(value, base) + println(); }
+size_t Print::println(long value, int base)           { return print(value, base) + println(); }
+size_t Print::println(unsigned long value, int base)  { return print(value, base) + println(); }
+size_t Print::println(double value, int digits)       { return print(value, digits) + println(); }
+
+/************************************************************
+ *                         SERIAL                           *
+ ************************************************************/
+// A transmissão é modelada como a UART real: o buffer esvazia à
+// taxa do baud rate e write() bloqueia quando ele está cheio.
+HardwareSerial::HardwareSerial() : byteUs(1042), txQueued(0), txClock(0) {}
+
+void HardwareSerial::begin(unsigned long baud) {
+  byteUs   = 10UL * 1000000UL / baud;   // 8N1 = 10 bits por byte
+  txQueued = 0;
+  txClock  = simMicros();
+}
+
+// Bytes injetados pelo driver da simulação: chegam à taxa do baud
+// rate atual e, com o buffer de recepção cheio, são perdidos
+static uint8_t  rxPending[1024];
+static size_t   rxPendingLen  = 0;
+static size_t   rxPendingNext = 0;
+static uint64_t rxNextUs      = 0;
+static uint8_t  rxBuffer[SERIAL_RX_BUFFER];
+static unsigned rxHead = 0, rxTail = 0;
+
+void simSerialInject(const uint8_t* data, size_t len) {
+  rxPendingLen  = 0;
+  rxPendingNext = 0;
+  for (size_t i = 0; i < len && i < sizeof(rxPending); i++) rxPending[rxPendingLen++] = data[i];
+  rxNextUs = simMicros();
+}
+
+static void receive(unsigned long byteUs) {
+  uint64_t now = simMicros();
+  while (rxPendingNext < rxPendingLen && rxNextUs + byteUs <= now) {
+    rxNextUs += byteUs;
+    unsigned next = (rxHead + 1) % SERIAL_RX_BUFFER;
+    if (next != rxTail) {
+      rxBuffer[rxHead] = rxPending[rxPendingNext];
+      rxHead = next;
+    }
+    rxPendingNext++;
+  }
+}
+
+int HardwareSerial::available() {
+  receive(byteUs);
+  return (int)((rxHead + SERIAL_RX_BUFFER - rxTail) % SERIAL_RX_BUFFER);
+}
+
+int HardwareSerial::read() {
+  receive(byteUs);
+  if (rxHead == rxTail) return -1;
+  uint8_t value = rxBuffer[rxTail];
+  rxTail = (rxTail + 1) % SERIAL_RX_BUFFER;
+  return value;
+}
+
+void HardwareSerial::drain() {
+  uint64_t now = simMicros();
+  if (txQueued == 0) {
+    txClock = now;
+    return;
+  }
+  uint64_t sent = (now - txClock) / byteUs;
+  if (sent >= txQueued) {
+    txQueued = 0;
+    txClock  = now;
+  }
+  else {
+    txQueued -= (unsigned int)sent;
+    txClock  += sent * byteUs;
+  }
+}
+
+void HardwareSerial::flush() {
+  drain();
+  if (txQueued > 0) {
+    uint64_t wait = txClock + (uint64_t)txQueued * byteUs - simMicros();
+    simStats.serialStallUs += wait;
+    simAdvanceMicros(wait);
+    drain();
+  }
+}
+
+int HardwareSerial::availableForWrite() {
+  drain();
+  return SERIAL_TX_BUFFER - (int)txQueued;
+}
+
+size_t HardwareSerial::write(uint8_t value) {
+  drain();
+  if (txQueued >= SERIAL_TX_BUFFER) {
+    uint64_t wait = txClock + byteUs - simMicros();
+    simStats.serialStallUs += wait;
+    simAdvanceMicros(wait);
+    drain();
+  }
+  txQueued++;
+  simStats.serialBytes++;
+  if (simSerialOut) fputc(value, simSerialOut);
+  return 1;
+}
@@ -0,0 +1,222 @@
+/************************************************************
+ *            HAL DE HOST: NÚCLEO ARDUINO SIMULADO          *
+ ************************************************************/
+// Implementa, sobre o relógio virtual de sim.h, o subconjunto da
+// API Arduino usado pelo firmware. O código da aplicação compila
+// sem alterações contra este cabeçalho ou contra o núcleo real.
+#ifndef ARDUINO_H_HOST
+#define ARDUINO_H_HOST
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+#include "avr/pgmspace.h"
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+#define HIGH 1
+#define LOW  0
+
+#define INPUT        0
+#define OUTPUT       1
+#define INPUT_PULLUP 2
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// Constantes binárias (binary.h do núcleo Arduino), só as de 5 bits
+#define B00000 0
+#define B00001 1
+#define B00010 2
+#define B00011 3
+#define B00100 4
+#define B00101 5
+#define B00110 6
+#define B00111 7
+#define B01000 8
+#define B01001 9
+#define B01010 10
+#define B01011 11
+#define B01100 12
+#define B01101 13
+#define B01110 14
+#define B01111 15
+#define B10000 16
+#define B10001 17
+#define B10010 18
+#define B10011 19
+#define B10100 20
+#define B10101 21
+#define B10110 22
+#define B10111 23
+#define B11000 24
+#define B11001 25
+#define B11010 26
+#define B11011 27
+#define B11100 28
+#define B11101 29
+#define B11110 30
+#define B11111 31
+
+/************************************************************
+ *                     TEMPO E PINOS                        *
+ ************************************************************/
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int  digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t level);
+int  analogRead(uint8_t pin);
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+long map(long value, long fromLow, long fromHigh, long toLow, long toHigh);
+
+/************************************************************
+ *                 INTERRUPÇÕES EXTERNAS                    *
+ ************************************************************/
+// INT0 no pino 2 e INT1 no pino 3, como no ATmega328P. A ISR roda
+// no instante virtual da borda, no meio do que o firmware estiver
+// fazendo, como no hardware.
+#define CHANGE  1
+#define FALLING 2
+#define RISING  3
+#define NOT_AN_INTERRUPT -1
+#define digitalPinToInterrupt(p) ((p) == 2 ? 0 : ((p) == 3 ? 1 : NOT_AN_INTERRUPT))
+
+void attachInterrupt(uint8_t interruptNum, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t interruptNum);
+inline void interrupts()   {}
+inline void noInterrupts() {}
+
+inline bool isWhitespace(int c) {
+  return c == ' ' || c == '\t';
+}
+
+/************************************************************
+ *                  STRINGS EM "FLASH"                      *
+ ************************************************************/
+// No host não há espaço de endereçamento separado para a flash
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+
+/************************************************************
+ *                         STRING                           *
+ ************************************************************/
+class String {
+public:
+  String() {}
+  String(const char* cstr) : buffer(cstr ? cstr : "") {}
+  String(const std::string& str) : buffer(str) {}
+  explicit String(char c) : buffer(1, c) {}
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(float value, unsigned char decimalPlaces = 2);
+  explicit String(double value, unsigned char decimalPlaces = 2);
+
+  unsigned int length() const        { return (unsigned int)buffer.size(); }
+  const char*  c_str() const         { return buffer.c_str(); }
+  char operator[](unsigned int i) const { return i < buffer.size() ? buffer[i] : 0; }
+
+  String& operator+=(const String& rhs) { buffer += rhs.buffer; return *this; }
+  String& operator+=(const char* rhs)   { buffer += rhs; return *this; }
+  String& operator+=(char rhs)          { buffer += rhs; return *this; }
+
+  bool operator==(const String& rhs) const { return buffer == rhs.buffer; }
+  bool operator==(const char* rhs) const   { return buffer == rhs; }
+
+private:
+  std::string buffer;
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
+
+/************************************************************
+ *                     PRINT / SERIAL                       *
+ ************************************************************/
+class Print {
+public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t value) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  virtual int    availableForWrite() { return 0; }
+  size_t write(const char* str) {
+    return str ? write((const uint8_t*)str, strlen(str)) : 0;
+  }
+
+  size_t print(const __FlashStringHelper* str);
+  size_t print(const String& str);
+  size_t print(const char str[]);
+  size_t print(char c);
+  size_t print(unsigned char value, int base = DEC);
+  size_t print(int value, int base = DEC);
+  size_t print(unsigned int value, int base = DEC);
+  size_t print(long value, int base = DEC);
+  size_t print(unsigned long value, int base = DEC);
+  size_t print(double value, int digits = 2);
+
+  size_t println(const __FlashStringHelper* str);
+  size_t println(const String& str);
+  size_t println(const char str[]);
+  size_t println(char c);
+  size_t println(unsigned char value, int base = DEC);
+  size_t println(int value, int base = DEC);
+  size_t println(unsigned int value, int base = DEC);
+  size_t println(long value, int base = DEC);
+  size_t println(unsigned long value, int base = DEC);
+  size_t println(double value, int digits = 2);
+  size_t println();
+
+private:
+  size_t printNumber(unsigned long value, int base);
+  size_t printSigned(long value, int base);
+};
+
+class HardwareSerial : public Print {
+public:
+  HardwareSerial();
+
+  void begin(unsigned long baud);
+  void end() {}
+  int  available();
+  int  read();
+  void flush();
+  virtual int availableForWrite();
+  operator bool() const { return true; }
+
+  virtual size_t write(uint8_t value);
+  using Print::write;
+
+private:
+  void drain();
+
+  unsigned long byteUs;
+  unsigned int  txQueued;
+  uint64_t      txClock;
+};
+
+extern HardwareSerial Serial;
+
+#endif
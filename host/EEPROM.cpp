@@ -0,0 +1,45 @@
+#include "EEPROM.h"
+
+#include "sim.h"
+
+#define EEPROM_WRITE_US 3300
+
+EEPROMClass EEPROM;
+
+EEPROMClass::EEPROMClass() {
+  erase();
+}
+
+void EEPROMClass::erase() {
+  memset(cells, 0xFF, sizeof(cells));
+  memset(writes, 0, sizeof(writes));
+}
+
+uint8_t EEPROMClass::read(int address) {
+  simStats.eepromReads++;
+  return cells[address % EEPROM_SIZE];
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+  address %= EEPROM_SIZE;
+  cells[address] = value;
+  writes[address]++;
+  simStats.eepromWrites++;
+  simAdvanceMicros(EEPROM_WRITE_US);
+}
+
+void EEPROMClass::update(int address, uint8_t value) {
+  if (cells[address % EEPROM_SIZE] != value) write(address, value);
+}
+
+unsigned long EEPROMClass::cellWrites(int address) const {
+  return writes[address % EEPROM_SIZE];
+}
+
+unsigned long EEPROMClass::maxCellWrites() const {
+  unsigned long worst = 0;
+  for (int i = 0; i < EEPROM_SIZE; i++) {
+    if (writes[i] > worst) worst = writes[i];
+  }
+  return worst;
+}
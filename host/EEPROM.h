@@ -0,0 +1,49 @@
+/************************************************************
+ *              HAL DE HOST: EEPROM EM MEMÓRIA              *
+ ************************************************************/
+// Mesma interface da EEPROM do núcleo AVR (ATmega328P, 1 KB).
+// Conta gravações por célula para medir desgaste; cada gravação
+// efetiva custa os ~3,3 ms do ciclo de escrita real.
+#ifndef EEPROM_H_HOST
+#define EEPROM_H_HOST
+
+#include "Arduino.h"
+
+#define EEPROM_SIZE 1024
+
+class EEPROMClass {
+public:
+  EEPROMClass();
+
+  int      begin()  { return 0; }
+  uint16_t length() { return EEPROM_SIZE; }
+
+  uint8_t read(int address);
+  void    write(int address, uint8_t value);
+  void    update(int address, uint8_t value);
+
+  template <typename T> T& get(int address, T& value) {
+    uint8_t* ptr = (uint8_t*)&value;
+    for (size_t i = 0; i < sizeof(T); i++) ptr[i] = read(address + (int)i);
+    return value;
+  }
+
+  template <typename T> const T& put(int address, const T& value) {
+    const uint8_t* ptr = (const uint8_t*)&value;
+    for (size_t i = 0; i < sizeof(T); i++) update(address + (int)i, ptr[i]);
+    return value;
+  }
+
+  // ==== INSPEÇÃO (só no host) ====
+  unsigned long cellWrites(int address) const;
+  unsigned long maxCellWrites() const;
+  void          erase();
+
+private:
+  uint8_t       cells[EEPROM_SIZE];
+  unsigned long writes[EEPROM_SIZE];
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,113 @@
+#include "LiquidCrystal_I2C.h"
+
+#include "sim.h"
+
+// Atrasos da biblioteca real (pulseEnable e comandos lentos)
+#define LCD_PULSE_US  51
+#define LCD_SLOW_US   2000
+
+LiquidCrystal_I2C::LiquidCrystal_I2C(uint8_t addr, uint8_t cols, uint8_t rows)
+  : address(addr), cols(cols), rows(rows), cursorCol(0), cursorRow(0),
+    backlightOn(false), backlightSince(0), backlightTotal(0), cgramWriteCount(0) {
+  if (this->cols > LCD_MAX_COLS) this->cols = LCD_MAX_COLS;
+  if (this->rows > LCD_MAX_ROWS) this->rows = LCD_MAX_ROWS;
+  memset(ddram, ' ', sizeof(ddram));
+  memset(cgram, 0, sizeof(cgram));
+}
+
+void LiquidCrystal_I2C::sendByte() {
+  for (int nibble = 0; nibble < 2; nibble++) {
+    for (int i = 0; i < 3; i++) {
+      simI2cTransaction(1);
+      simStats.lcdTransactions++;
+    }
+    simAdvanceMicros(LCD_PULSE_US);
+  }
+}
+
+void LiquidCrystal_I2C::command() {
+  sendByte();
+}
+
+void LiquidCrystal_I2C::init() {
+  begin();
+}
+
+void LiquidCrystal_I2C::begin() {
+  // Sequência de inicialização em 4 bits + function set/display/entry mode
+  for (int i = 0; i < 4; i++) command();
+  clear();
+}
+
+void LiquidCrystal_I2C::clear() {
+  command();
+  simAdvanceMicros(LCD_SLOW_US);
+  memset(ddram, ' ', sizeof(ddram));
+  cursorCol = 0;
+  cursorRow = 0;
+}
+
+void LiquidCrystal_I2C::home() {
+  command();
+  simAdvanceMicros(LCD_SLOW_US);
+  cursorCol = 0;
+  cursorRow = 0;
+}
+
+void LiquidCrystal_I2C::setCursor(uint8_t col, uint8_t row) {
+  command();
+  if (row >= rows) row = rows - 1;
+  cursorCol = col;
+  cursorRow = row;
+}
+
+void LiquidCrystal_I2C::backlight() {
+  simI2cTransaction(1);
+  simStats.lcdTransactions++;
+  if (!backlightOn) backlightSince = simMicros();
+  backlightOn = true;
+}
+
+void LiquidCrystal_I2C::noBacklight() {
+  simI2cTransaction(1);
+  simStats.lcdTransactions++;
+  if (backlightOn) backlightTotal += simMicros() - backlightSince;
+  backlightOn = false;
+}
+
+uint64_t LiquidCrystal_I2C::backlightMicros() const {
+  return backlightTotal + (backlightOn ? simMicros() - backlightSince : 0);
+}
+
+void LiquidCrystal_I2C::createChar(uint8_t location, uint8_t charmap[]) {
+  location &= 0x7;
+  command();
+  for (int i = 0; i < 8; i++) {
+    sendByte();
+    cgram[location][i] = charmap[i];
+  }
+  cgramWriteCount++;
+}
+
+size_t LiquidCrystal_I2C::write(uint8_t value) {
+  sendByte();
+  if (cursorCol < cols) {
+    ddram[cursorRow][cursorCol] = (char)value;
+  }
+  cursorCol++;
+  return 1;
+}
+
+char LiquidCrystal_I2C::charAt(uint8_t col, uint8_t row) const {
+  if (col >= cols || row >= rows) return ' ';
+  return ddram[row][col];
+}
+
+const char* LiquidCrystal_I2C::rowText(uint8_t row) const {
+  for (uint8_t c = 0; c < cols; c++) {
+    char ch = charAt(c, row);
+    rowBuffer[c] = (ch >= 0 && ch < 8) ? (char)('0' + ch) : ch;
+  }
+  rowBuffer[cols] = '\0';
+  return rowBuffer;
+}
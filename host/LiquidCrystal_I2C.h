@@ -0,0 +1,56 @@
+/************************************************************
+ *        HAL DE HOST: LCD 16x2 COM BACKPACK PCF8574        *
+ ************************************************************/
+// Mesma interface da LiquidCrystal_I2C. Guarda o conteúdo da tela
+// num buffer de caracteres e modela o custo de barramento da
+// biblioteca real: cada byte vai em dois nibbles, e cada nibble
+// custa três transações I2C de um byte (dado, EN alto, EN baixo).
+#ifndef LIQUIDCRYSTAL_I2C_H_HOST
+#define LIQUIDCRYSTAL_I2C_H_HOST
+
+#include "Arduino.h"
+
+#define LCD_MAX_COLS 20
+#define LCD_MAX_ROWS 4
+
+class LiquidCrystal_I2C : public Print {
+public:
+  LiquidCrystal_I2C(uint8_t addr, uint8_t cols, uint8_t rows);
+
+  void init();
+  void begin();
+  void clear();
+  void home();
+  void setCursor(uint8_t col, uint8_t row);
+  void backlight();
+  void noBacklight();
+  void createChar(uint8_t location, uint8_t charmap[]);
+
+  virtual size_t write(uint8_t value);
+
+  // ==== INSPEÇÃO (só no host) ====
+  char        charAt(uint8_t col, uint8_t row) const;
+  const char* rowText(uint8_t row) const;      // custom chars viram '0'..'7'
+  bool        isBacklightOn() const { return backlightOn; }
+  uint64_t    backlightMicros() const;     // tempo total com a luz acesa
+  unsigned long cgramWrites() const { return cgramWriteCount; }
+
+private:
+  void sendByte();
+  void command();
+
+  uint8_t address;
+  uint8_t cols;
+  uint8_t rows;
+  uint8_t cursorCol;
+  uint8_t cursorRow;
+  bool    backlightOn;
+  uint64_t backlightSince;
+  uint64_t backlightTotal;
+  char    ddram[LCD_MAX_ROWS][LCD_MAX_COLS];
+  uint8_t cgram[8][8];
+  mutable char rowBuffer[LCD_MAX_COLS + 1];
+  unsigned long cgramWriteCount;
+};
+
+#endif
@@ -0,0 +1,136 @@
+#include "RTClib.h"
+
+#include "sim.h"
+
+// Dias desde 1970-01-01 (algoritmo civil de H. Hinnant)
+static int32_t daysFromCivil(int32_t y, uint32_t m, uint32_t d) {
+  y -= m <= 2;
+  const int32_t  era = (y >= 0 ? y : y - 399) / 400;
+  const uint32_t yoe = (uint32_t)(y - era * 400);
+  const uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + (int32_t)doe - 719468;
+}
+
+static void civilFromDays(int32_t z, int32_t& y, uint32_t& m, uint32_t& d) {
+  z += 719468;
+  const int32_t  era = (z >= 0 ? z : z - 146096) / 146097;
+  const uint32_t doe = (uint32_t)(z - era * 146097);
+  const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const uint32_t mp  = (5 * doy + 2) / 153;
+  d = doy - (153 * mp + 2) / 5 + 1;
+  m = mp < 10 ? mp + 3 : mp - 9;
+  y = (int32_t)yoe + era * 400 + (m <= 2);
+}
+
+/************************************************************
+ *                        DATETIME                          *
+ ************************************************************/
+DateTime::DateTime(uint32_t t) {
+  int32_t  y;
+  uint32_t mo, dd;
+  civilFromDays((int32_t)(t / 86400UL), y, mo, dd);
+  uint32_t secs = t % 86400UL;
+  yOff = (uint8_t)(y - 2000);
+  m    = (uint8_t)mo;
+  d    = (uint8_t)dd;
+  hh   = (uint8_t)(secs / 3600);
+  mm   = (uint8_t)((secs / 60) % 60);
+  ss   = (uint8_t)(secs % 60);
+}
+
+DateTime::DateTime(uint16_t year, uint8_t month, uint8_t day,
+                   uint8_t hour, uint8_t min, uint8_t sec)
+  : yOff((uint8_t)(year >= 2000 ? year - 2000 : year)), m(month), d(day),
+    hh(hour), mm(min), ss(sec) {}
+
+static uint8_t conv2d(const char* p) {
+  uint8_t v = 0;
+  if ('0' <= *p && *p <= '9') v = *p - '0';
+  return 10 * v + *++p - '0';
+}
+
+// Formato de __DATE__ ("Mar 20 2025") e __TIME__ ("19:30:45")
+DateTime::DateTime(const char* date, const char* time) {
+  static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+  yOff = conv2d(date + 9);
+  m    = 1;
+  for (int i = 0; i < 12; i++) {
+    if (strncmp(date, &months[i * 3], 3) == 0) { m = i + 1; break; }
+  }
+  d  = conv2d(date + 4);
+  hh = conv2d(time);
+  mm = conv2d(time + 3);
+  ss = conv2d(time + 6);
+}
+
+DateTime::DateTime(const __FlashStringHelper* date, const __FlashStringHelper* time) {
+  *this = DateTime(reinterpret_cast<const char*>(date), reinterpret_cast<const char*>(time));
+}
+
+uint8_t DateTime::dayOfTheWeek() const {
+  // 1970-01-01 foi uma quinta-feira (4); domingo = 0
+  return (uint8_t)((unixtime() / 86400UL + 4) % 7);
+}
+
+uint32_t DateTime::unixtime() const {
+  return (uint32_t)daysFromCivil(2000 + yOff, m, d) * 86400UL
+       + (uint32_t)hh * 3600UL + (uint32_t)mm * 60UL + ss;
+}
+
+/************************************************************
+ *                        RTC_DS3231                        *
+ ************************************************************/
+RTC_DS3231::RTC_DS3231()
+  : baseUnix(DateTime(2025, 3, 20, 0, 0, 0).unixtime()), baseMicros(0), powerLost(false),
+    sqwMode(DS3231_OFF) {}
+
+bool RTC_DS3231::begin(TwoWire* wireInstance) {
+  (void)wireInstance;
+  simI2cTransaction(0);                 // sonda o endereço 0x68
+  simStats.rtcTransactions++;
+  return true;
+}
+
+void RTC_DS3231::adjust(const DateTime& dt) {
+  simI2cTransaction(8);                 // ponteiro + 7 registradores
+  simI2cTransaction(2);                 // limpa o flag OSF
+  simStats.rtcTransactions += 2;
+  baseUnix   = dt.unixtime();
+  baseMicros = simMicros();
+  powerLost  = false;
+  // Gravar os segundos reinicia a contagem do segundo e a onda SQW
+  if (sqwMode == DS3231_SquareWave1Hz) simSqwStart(baseMicros + 1000000);
+}
+
+DateTime RTC_DS3231::now() {
+  simI2cTransaction(1);                 // ponteiro de registrador
+  simI2cTransaction(7);                 // leitura dos 7 registradores
+  simStats.rtcTransactions += 2;
+  return DateTime(baseUnix + (uint32_t)((simMicros() - baseMicros) / 1000000ULL));
+}
+
+bool RTC_DS3231::lostPower() {
+  simI2cTransaction(1);
+  simI2cTransaction(1);
+  simStats.rtcTransactions += 2;
+  return powerLost;
+}
+
+void RTC_DS3231::writeSqwPinMode(Ds3231SqwPinMode mode) {
+  simI2cTransaction(1);                 // lê o registrador de controle
+  simI2cTransaction(1);
+  simI2cTransaction(2);                 // grava o novo valor
+  simStats.rtcTransactions += 3;
+  sqwMode = mode;
+  if (mode == DS3231_SquareWave1Hz) simSqwStart(baseMicros);
+  else                              simSqwStop();
+}
+
+Ds3231SqwPinMode RTC_DS3231::readSqwPinMode() {
+  simI2cTransaction(1);
+  simI2cTransaction(1);
+  simStats.rtcTransactions += 2;
+  return sqwMode;
+}
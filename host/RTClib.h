@@ -0,0 +1,78 @@
+/************************************************************
+ *           HAL DE HOST: DS3231 COM RELÓGIO VIRTUAL        *
+ ************************************************************/
+// Mesma interface da RTClib da Adafruit (DateTime e RTC_DS3231).
+// O DS3231 simulado conta a partir do relógio virtual de sim.h;
+// cada now() custa as duas transações I2C da biblioteca real. A
+// saída SQW de 1 Hz é gerada no pino ligado com simSqwAttach().
+#ifndef RTCLIB_H_HOST
+#define RTCLIB_H_HOST
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#define SECONDS_FROM_1970_TO_2000 946684800
+
+class TimeSpan {
+public:
+  TimeSpan(int32_t seconds = 0) : totalSeconds(seconds) {}
+  TimeSpan(int16_t days, int8_t hours, int8_t minutes, int8_t seconds)
+    : totalSeconds((int32_t)days * 86400L + (int32_t)hours * 3600 + (int32_t)minutes * 60 + seconds) {}
+  int32_t totalseconds() const { return totalSeconds; }
+private:
+  int32_t totalSeconds;
+};
+
+class DateTime {
+public:
+  DateTime(uint32_t t = SECONDS_FROM_1970_TO_2000);
+  DateTime(uint16_t year, uint8_t month, uint8_t day,
+           uint8_t hour = 0, uint8_t min = 0, uint8_t sec = 0);
+  DateTime(const char* date, const char* time);
+  DateTime(const __FlashStringHelper* date, const __FlashStringHelper* time);
+
+  uint16_t year() const      { return 2000U + yOff; }
+  uint8_t  month() const     { return m; }
+  uint8_t  day() const       { return d; }
+  uint8_t  hour() const      { return hh; }
+  uint8_t  minute() const    { return mm; }
+  uint8_t  second() const    { return ss; }
+  uint8_t  dayOfTheWeek() const;
+  uint32_t unixtime() const;
+
+  DateTime operator+(const TimeSpan& span) const { return DateTime(unixtime() + span.totalseconds()); }
+  DateTime operator-(const TimeSpan& span) const { return DateTime(unixtime() - span.totalseconds()); }
+
+private:
+  uint8_t yOff, m, d, hh, mm, ss;
+};
+
+// Saída SQW/INT do DS3231 (registrador de controle)
+enum Ds3231SqwPinMode {
+  DS3231_OFF            = 0x1C,
+  DS3231_SquareWave1Hz  = 0x00,
+  DS3231_SquareWave1kHz = 0x08,
+  DS3231_SquareWave4kHz = 0x10,
+  DS3231_SquareWave8kHz = 0x18
+};
+
+class RTC_DS3231 {
+public:
+  RTC_DS3231();
+
+  bool     begin(TwoWire* wireInstance = &Wire);
+  void     adjust(const DateTime& dt);
+  DateTime now();
+  bool     lostPower();
+  // Só a onda de 1 Hz é simulada (ver simSqwAttach)
+  void             writeSqwPinMode(Ds3231SqwPinMode mode);
+  Ds3231SqwPinMode readSqwPinMode();
+
+private:
+  uint32_t baseUnix;     // hora do RTC quando o relógio virtual valia baseMicros
+  uint64_t baseMicros;
+  bool     powerLost;
+  Ds3231SqwPinMode sqwMode;
+};
+
+#endif
@@ -0,0 +1,108 @@
+#include "Wire.h"
+
+#include "sim.h"
+
+// AT24C32: 4 KB, páginas de 32 bytes, ciclo de escrita de 5 ms
+#define AT24_SIM_ADDRESS  0x57
+#define AT24_SIM_SIZE     4096
+#define AT24_SIM_PAGE     32
+#define AT24_SIM_WRITE_US 5000
+
+static bool          at24Attached = false;
+static uint8_t       at24Cells[AT24_SIM_SIZE];
+static unsigned long at24PageCycles[AT24_SIM_SIZE / AT24_SIM_PAGE];
+static uint16_t      at24Pointer  = 0;
+static uint64_t      at24BusyUntil = 0;
+
+TwoWire Wire;
+
+void simAt24Attach(bool present) {
+  at24Attached  = present;
+  at24Pointer   = 0;
+  at24BusyUntil = 0;
+  memset(at24Cells, 0xFF, sizeof(at24Cells));
+  memset(at24PageCycles, 0, sizeof(at24PageCycles));
+}
+
+unsigned long simAt24MaxPageWrites() {
+  unsigned long worst = 0;
+  for (unsigned i = 0; i < AT24_SIM_SIZE / AT24_SIM_PAGE; i++) {
+    if (at24PageCycles[i] > worst) worst = at24PageCycles[i];
+  }
+  return worst;
+}
+
+// O chip só reconhece o endereço fora de um ciclo de escrita
+static bool at24Acks(uint8_t address) {
+  return at24Attached && address == AT24_SIM_ADDRESS && simMicros() >= at24BusyUntil;
+}
+
+TwoWire::TwoWire() : txAddress(0), txLength(0), rxLength(0), rxIndex(0) {}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  txAddress = address;
+  txLength  = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (txLength >= BUFFER_LENGTH) return 0;
+  txBuffer[txLength++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t len) {
+  size_t n = 0;
+  while (n < len && write(data[n])) n++;
+  return n;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  (void)sendStop;
+  simI2cTransaction(txLength);
+  if (!at24Acks(txAddress)) return 2;
+
+  // Endereço de 12 bits, depois os dados; a escrita dá a volta dentro
+  // da página, como no chip
+  if (txLength >= 2) at24Pointer = (uint16_t)(((txBuffer[0] << 8) | txBuffer[1]) % AT24_SIM_SIZE);
+  if (txLength > 2) {
+    uint16_t page = at24Pointer & ~(AT24_SIM_PAGE - 1);
+    for (uint8_t i = 2; i < txLength; i++) {
+      at24Cells[page | (at24Pointer & (AT24_SIM_PAGE - 1))] = txBuffer[i];
+      at24Pointer = page | ((at24Pointer + 1) & (AT24_SIM_PAGE - 1));
+    }
+    at24PageCycles[page / AT24_SIM_PAGE]++;
+    simStats.at24WriteCycles++;
+    simStats.at24BytesWritten += txLength - 2;
+    at24BusyUntil = simMicros() + AT24_SIM_WRITE_US;
+  }
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool sendStop) {
+  (void)sendStop;
+  if (quantity > BUFFER_LENGTH) quantity = BUFFER_LENGTH;
+  rxIndex  = 0;
+  rxLength = 0;
+  if (!at24Acks(address)) {
+    simI2cTransaction(0);
+    return 0;
+  }
+
+  // Leitura sequencial a partir do ponteiro interno
+  simI2cTransaction(quantity);
+  for (uint8_t i = 0; i < quantity; i++) {
+    rxBuffer[i] = at24Cells[at24Pointer];
+    at24Pointer = (at24Pointer + 1) % AT24_SIM_SIZE;
+  }
+  simStats.at24BytesRead += quantity;
+  rxLength = quantity;
+  return quantity;
+}
+
+int TwoWire::available() {
+  return rxLength - rxIndex;
+}
+
+int TwoWire::read() {
+  return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1;
+}
@@ -0,0 +1,44 @@
+/************************************************************
+ *                 HAL DE HOST: BARRAMENTO I2C              *
+ ************************************************************/
+// LCD e RTC contabilizam as próprias transações em sim.h. As
+// transmissões feitas pela Wire vão para os dispositivos simulados
+// no barramento (hoje, a EEPROM AT24C32 do módulo do DS3231); um
+// endereço sem dispositivo, ou ocupado, responde com NACK.
+#ifndef WIRE_H_HOST
+#define WIRE_H_HOST
+
+#include "Arduino.h"
+
+// Mesmo tamanho do buffer da Wire do núcleo AVR
+#define BUFFER_LENGTH 32
+
+class TwoWire {
+public:
+  TwoWire();
+
+  void begin() {}
+  void setClock(unsigned long frequency) { (void)frequency; }
+
+  void    beginTransmission(uint8_t address);
+  size_t  write(uint8_t data);
+  size_t  write(const uint8_t* data, size_t len);
+  // 0 = ok, 2 = NACK no endereço, 3 = NACK nos dados
+  uint8_t endTransmission(bool sendStop = true);
+
+  uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true);
+  int     available();
+  int     read();
+
+private:
+  uint8_t txAddress;
+  uint8_t txBuffer[BUFFER_LENGTH];
+  uint8_t txLength;
+  uint8_t rxBuffer[BUFFER_LENGTH];
+  uint8_t rxLength;
+  uint8_t rxIndex;
+};
+
+extern TwoWire Wire;
+
+#endif
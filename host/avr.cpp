@@ -0,0 +1,171 @@
+#include "avr/io.h"
+
+#include "sim.h"
+
+// Registradores
+volatile uint8_t  ADMUX;
+volatile uint8_t  ADCSRA;
+volatile uint8_t  ADCSRB;
+volatile uint8_t  DIDR0;
+volatile uint16_t ADC;
+
+volatile uint8_t  TCCR1A;
+volatile uint8_t  TCCR1B;
+volatile uint8_t  TIMSK1;
+volatile uint8_t  TIFR1;
+volatile uint16_t TCNT1;
+volatile uint16_t OCR1A;
+volatile uint16_t OCR1B;
+
+volatile uint8_t  PCICR;
+volatile uint8_t  PCIFR;
+volatile uint8_t  PCMSK0;
+volatile uint8_t  PCMSK1;
+volatile uint8_t  PCMSK2;
+
+volatile uint8_t  EICRA;
+volatile uint8_t  EIMSK;
+SimFlagRegister   EIFR;
+
+volatile uint8_t  WDTCSR;
+volatile uint8_t  PRR;
+
+// Vetores definidos pelo firmware com ISR(); ausentes = NULL
+extern "C" void ADC_vect(void) __attribute__((weak));
+extern "C" void PCINT0_vect(void) __attribute__((weak));
+extern "C" void PCINT1_vect(void) __attribute__((weak));
+extern "C" void PCINT2_vect(void) __attribute__((weak));
+extern "C" void WDT_vect(void) __attribute__((weak));
+
+// Conversão do ADC: 13 ciclos do clock do ADC
+#define ADC_CONVERSION_CYCLES 13
+#define ADTS_TIMER1_COMPB     5
+
+static const uint16_t timerPrescaler[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+
+static bool     adcRunning   = false;
+static uint64_t adcTriggerUs = 0;    // próxima comparação B do Timer1
+static uint64_t adcPeriodUs  = 0;
+
+// Período da comparação B em CTC, ou 0 se o ADC não está nesse modo
+static uint64_t timerTriggerPeriodUs() {
+  if (!(ADCSRA & _BV(ADEN)) || !(ADCSRA & _BV(ADATE))) return 0;
+  if ((ADCSRB & 0x07) != ADTS_TIMER1_COMPB) return 0;
+  if (!(TCCR1B & _BV(WGM12))) return 0;
+  uint16_t prescaler = timerPrescaler[TCCR1B & 0x07];
+  if (prescaler == 0) return 0;
+  return (uint64_t)(OCR1A + 1) * prescaler * 1000000ULL / F_CPU;
+}
+
+static uint64_t adcConversionUs() {
+  uint8_t div = 1 << (ADCSRA & 0x07);
+  if (div < 2) div = 2;
+  return (uint64_t)ADC_CONVERSION_CYCLES * div * 1000000ULL / F_CPU;
+}
+
+// Watchdog: oscilador de 128 kHz, 2048 ciclos (16 ms) << WDP
+static uint64_t wdtResetUs = 0;     // último wdt_reset()
+
+static uint64_t wdtPeriodUs() {
+  uint8_t prescale = (WDTCSR & 0x07) | ((WDTCSR & _BV(WDP3)) ? 0x08 : 0);
+  if (prescale > 9) prescale = 9;
+  return 16000ULL << prescale;
+}
+
+static uint64_t adcNextEvent() {
+  uint64_t period = timerTriggerPeriodUs();
+  if (period == 0) {
+    adcRunning = false;
+    return UINT64_MAX;
+  }
+  if (!adcRunning || period != adcPeriodUs) {
+    // Configuração nova: o timer começa a contar agora
+    adcRunning   = true;
+    adcPeriodUs  = period;
+    adcTriggerUs = simMicros() + period;
+  }
+  // A interrupção sai no fim da conversão disparada pela comparação
+  return adcTriggerUs + adcConversionUs();
+}
+
+static uint64_t wdtNextEvent() {
+  if (!(WDTCSR & (_BV(WDIE) | _BV(WDE)))) return UINT64_MAX;
+  return wdtResetUs + wdtPeriodUs();
+}
+
+uint64_t simAvrNextEvent() {
+  uint64_t adc = adcNextEvent();
+  uint64_t wdt = wdtNextEvent();
+  return adc < wdt ? adc : wdt;
+}
+
+void simAvrRunEvent() {
+  uint64_t adc = adcNextEvent();
+  uint64_t wdt = wdtNextEvent();
+
+  if (wdt < adc) {
+    wdtResetUs = wdt;
+    if (WDTCSR & _BV(WDIE)) {
+      // Modo interrupção: o hardware limpa WDIE antes da ISR
+      WDTCSR &= ~_BV(WDIE);
+      if (WDT_vect) {
+        simStats.interrupts++;
+        WDT_vect();
+      }
+    }
+    else {
+      simStats.watchdogResets++;
+    }
+    return;
+  }
+
+  ADC = (uint16_t)simLightRaw() & 0x3FF;
+  simStats.adcReads++;
+  adcTriggerUs += adcPeriodUs;
+  if ((ADCSRA & _BV(ADIE)) && ADC_vect) {
+    simStats.interrupts++;
+    ADC_vect();
+  }
+}
+
+void simWdtReset() {
+  wdtResetUs = simMicros();
+}
+
+/************************************************************
+ *              PORTAS E MUDANÇA DE PINO (PCINT)            *
+ ************************************************************/
+// Porta (0 = B, 1 = C, 2 = D) e bit de um pino do Arduino UNO
+static int pinPort(int pin, uint8_t& bit) {
+  if (pin < 8)  { bit = (uint8_t)pin;        return 2; }
+  if (pin < 14) { bit = (uint8_t)(pin - 8);  return 0; }
+  bit = (uint8_t)(pin - 14);
+  return 1;
+}
+
+uint8_t simAvrPortInput(uint8_t port) {
+  uint8_t value = 0;
+  for (int pin = 0; pin < SIM_NUM_PINS; pin++) {
+    uint8_t bit;
+    if (pinPort(pin, bit) == port && simPinLevel(pin)) value |= _BV(bit);
+  }
+  return value;
+}
+
+void simAvrPinChanged(int pin) {
+  static const volatile uint8_t* masks[3] = { &PCMSK0, &PCMSK1, &PCMSK2 };
+  static void (*const vectors[3])(void)   = { PCINT0_vect, PCINT1_vect, PCINT2_vect };
+
+  uint8_t bit;
+  int     port = pinPort(pin, bit);
+  if (!(*masks[port] & _BV(bit))) return;
+
+  // A ISR roda na hora se o grupo está habilitado; senão o pedido
+  // fica pendente no PCIFR
+  PCIFR |= _BV(port);
+  if ((PCICR & _BV(port)) && vectors[port]) {
+    PCIFR &= ~_BV(port);
+    simStats.interrupts++;
+    vectors[port]();
+  }
+}
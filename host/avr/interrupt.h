@@ -0,0 +1,14 @@
+/************************************************************
+ *          HAL DE HOST: ROTINAS DE INTERRUPÇÃO (ISR)       *
+ ************************************************************/
+// ISR(ADC_vect) vira uma função C comum, chamada pelo modelo dos
+// periféricos (host/avr.cpp) no instante virtual do evento.
+#ifndef AVR_INTERRUPT_H_HOST
+#define AVR_INTERRUPT_H_HOST
+
+#define ISR(vector) extern "C" void vector(void)
+
+inline void cli() {}
+inline void sei() {}
+
+#endif
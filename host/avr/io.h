@@ -0,0 +1,177 @@
+/************************************************************
+ *        HAL DE HOST: REGISTRADORES DO ATmega328P          *
+ ************************************************************/
+// Só os registradores usados pelo firmware, como variáveis comuns.
+// O modelo em host/avr.cpp observa a configuração deles a cada
+// avanço do relógio virtual e gera as interrupções correspondentes
+// (Timer1 em CTC disparando o ADC pela comparação B, interrupções
+// de mudança de pino e watchdog). As portas de entrada PINB/PINC/PIND são lidas
+// dos níveis dos pinos simulados.
+#ifndef AVR_IO_H_HOST
+#define AVR_IO_H_HOST
+
+#include <stdint.h>
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+
+// ==== WATCHDOG ====
+extern volatile uint8_t WDTCSR;
+
+#define WDIF 7
+#define WDIE 6
+#define WDP3 5
+#define WDCE 4
+#define WDE  3
+#define WDP2 2
+#define WDP1 1
+#define WDP0 0
+
+// ==== REDUÇÃO DE CONSUMO ====
+extern volatile uint8_t PRR;
+
+#define PRTWI    7
+#define PRTIM2   6
+#define PRTIM0   5
+#define PRTIM1   3
+#define PRSPI    2
+#define PRUSART0 1
+#define PRADC    0
+
+#endif
+
+#define _BV(bit) (1 << (bit))
+
+// ==== ADC ====
+extern volatile uint8_t  ADMUX;
+extern volatile uint8_t  ADCSRA;
+extern volatile uint8_t  ADCSRB;
+extern volatile uint8_t  DIDR0;
+extern volatile uint16_t ADC;
+
+#define REFS1 7
+#define REFS0 6
+#define ADLAR 5
+
+#define ADEN  7
+#define ADSC  6
+#define ADATE 5
+#define ADIF  4
+#define ADIE  3
+#define ADPS2 2
+#define ADPS1 1
+#define ADPS0 0
+
+#define ADTS2 2
+#define ADTS1 1
+#define ADTS0 0
+
+// ==== TIMER1 ====
+extern volatile uint8_t  TCCR1A;
+extern volatile uint8_t  TCCR1B;
+extern volatile uint8_t  TIMSK1;
+extern volatile uint8_t  TIFR1;
+extern volatile uint16_t TCNT1;
+extern volatile uint16_t OCR1A;
+extern volatile uint16_t OCR1B;
+
+#define WGM13 4
+#define WGM12 3
+#define CS12  2
+#define CS11  1
+#define CS10  0
+
+#define OCIE1B 2
+#define OCIE1A 1
+#define OCF1B  2
+#define OCF1A  1
+
+// ==== PORTAS E INTERRUPÇÕES DE MUDANÇA DE PINO ====
+// Pinos 8..13 = PORTB (PCINT0..5), A0..A5 = PORTC (PCINT8..13),
+// 0..7 = PORTD (PCINT16..23)
+uint8_t simAvrPortInput(uint8_t port);   // 0 = B, 1 = C, 2 = D
+
+#define PINB simAvrPortInput(0)
+#define PINC simAvrPortInput(1)
+#define PIND simAvrPortInput(2)
+
+extern volatile uint8_t PCICR;
+extern volatile uint8_t PCIFR;
+extern volatile uint8_t PCMSK0;
+extern volatile uint8_t PCMSK1;
+extern volatile uint8_t PCMSK2;
+
+#define PCIE2 2
+#define PCIE1 1
+#define PCIE0 0
+#define PCIF2 2
+#define PCIF1 1
+#define PCIF0 0
+
+#define PCINT0  0
+#define PCINT1  1
+#define PCINT2  2
+#define PCINT3  3
+#define PCINT4  4
+#define PCINT5  5
+#define PCINT16 0
+#define PCINT17 1
+#define PCINT18 2
+#define PCINT19 3
+#define PCINT20 4
+#define PCINT21 5
+#define PCINT22 6
+#define PCINT23 7
+
+// ==== INTERRUPÇÕES EXTERNAS INT0/INT1 ====
+// attachInterrupt() grava o sentido da borda em EICRA e liga o bit
+// em EIMSK; detachInterrupt() só desliga EIMSK. Uma borda no sentido
+// de EICRA marca o pedido em EIFR mesmo com a interrupção desligada,
+// e ele dispara a ISR assim que ela é ligada. Como no chip, escrever
+// 1 num bit de EIFR limpa o pedido; o modelo liga os bits por 'bits'.
+struct SimFlagRegister {
+  uint8_t bits;
+  operator uint8_t() const { return bits; }
+  SimFlagRegister& operator=(uint8_t clear) {
+    bits &= (uint8_t)~clear;
+    return *this;
+  }
+};
+
+extern volatile uint8_t EICRA;
+extern volatile uint8_t EIMSK;
+extern SimFlagRegister  EIFR;
+
+#define ISC11 3
+#define ISC10 2
+#define ISC01 1
+#define ISC00 0
+#define INT1  1
+#define INT0  0
+#define INTF1 1
+#define INTF0 0
+
+// ==== WATCHDOG ====
+extern volatile uint8_t WDTCSR;
+
+#define WDIF 7
+#define WDIE 6
+#define WDP3 5
+#define WDCE 4
+#define WDE  3
+#define WDP2 2
+#define WDP1 1
+#define WDP0 0
+
+// ==== REDUÇÃO DE CONSUMO ====
+extern volatile uint8_t PRR;
+
+#define PRTWI    7
+#define PRTIM2   6
+#define PRTIM0   5
+#define PRTIM1   3
+#define PRSPI    2
+#define PRUSART0 1
+#define PRADC    0
+
+#endif
@@ -0,0 +1,30 @@
+/************************************************************
+ *           HAL DE HOST: DADOS NA MEMÓRIA DE PROGRAMA       *
+ ************************************************************/
+// No AVR, PROGMEM põe constantes na flash e elas só são lidas pelas
+// funções pgm_read_* / *_P. No host a memória é uma só: os macros
+// viram leituras comuns, e o firmware compila igual nos dois. Os
+// dados vão para uma seção própria (.progmem) para que o relatório
+// de RAM (tools/ramreport.cmake) os conte como flash, como no AVR.
+#ifndef AVR_PGMSPACE_H_HOST
+#define AVR_PGMSPACE_H_HOST
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM                 __attribute__((section(".progmem.data")))
+#define PGM_P                   const char*
+#define PSTR(s)                 (__extension__({ static const char __c[] PROGMEM = (s); &__c[0]; }))
+
+#define pgm_read_byte(addr)     (*(const uint8_t*)(addr))
+#define pgm_read_word(addr)     (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr)    (*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr)      (*(void* const*)(addr))
+
+#define memcpy_P                memcpy
+#define strlen_P                strlen
+#define strcmp_P                strcmp
+#define strncmp_P               strncmp
+#define strncpy_P               strncpy
+
+#endif
@@ -0,0 +1,29 @@
+/************************************************************
+ *             HAL DE HOST: MODOS DE SONO DO AVR            *
+ ************************************************************/
+// sleep_cpu() avança o relógio virtual até a próxima interrupção
+// (borda de pino, periférico, SQW, watchdog ou o estouro do Timer0
+// que mantém o millis()) e contabiliza o tempo dormido em simStats.
+// Só o modo IDLE é modelado: os timers e o ADC continuam rodando.
+#ifndef AVR_SLEEP_H_HOST
+#define AVR_SLEEP_H_HOST
+
+#include <stdint.h>
+
+#define SLEEP_MODE_IDLE        0
+#define SLEEP_MODE_ADC         1
+#define SLEEP_MODE_PWR_DOWN    2
+#define SLEEP_MODE_PWR_SAVE    3
+#define SLEEP_MODE_STANDBY     6
+#define SLEEP_MODE_EXT_STANDBY 7
+
+void simSleepMode(uint8_t mode);
+void simSleepEnable(bool enabled);
+void simSleepCpu();
+
+#define set_sleep_mode(mode) simSleepMode(mode)
+#define sleep_enable()       simSleepEnable(true)
+#define sleep_disable()      simSleepEnable(false)
+#define sleep_cpu()          simSleepCpu()
+
+#endif
@@ -0,0 +1,37 @@
+/************************************************************
+ *             HAL DE HOST: WATCHDOG DO AVR                 *
+ ************************************************************/
+// Mesma interface da avr/wdt.h. O watchdog simulado (host/avr.cpp)
+// conta o período desde o último wdt_reset(): com WDIE, o estouro
+// chama WDT_vect e limpa WDIE, como no hardware; com só WDE, o
+// estouro seria um reset do MCU e é apenas contado em simStats.
+#ifndef AVR_WDT_H_HOST
+#define AVR_WDT_H_HOST
+
+#include "io.h"
+
+#define WDTO_15MS   0
+#define WDTO_30MS   1
+#define WDTO_60MS   2
+#define WDTO_120MS  3
+#define WDTO_250MS  4
+#define WDTO_500MS  5
+#define WDTO_1S     6
+#define WDTO_2S     7
+#define WDTO_4S     8
+#define WDTO_8S     9
+
+void simWdtReset();
+
+#define wdt_reset()  simWdtReset()
+
+inline void wdt_enable(uint8_t timeout) {
+  WDTCSR = _BV(WDE) | (timeout & 0x07) | ((timeout & 0x08) ? _BV(WDP3) : 0);
+  wdt_reset();
+}
+
+inline void wdt_disable() {
+  WDTCSR = 0;
+}
+
+#endif
@@ -0,0 +1,330 @@
+/************************************************************
+ *            SIMULAÇÃO DO DATA LOGGER NO HOST              *
+ ************************************************************/
+// Roda setup()/loop() do firmware sobre a HAL de host e imprime
+// contadores de vazão, barramento e desgaste da EEPROM.
+//
+//   datalogger-sim [--days N] [--hours N] [--seed N] [--serial | --serial-file F]
+//                  [--binary] [--no-ui] [--no-at24c32]
+//                  [--dump-at H [--dump-offset N] [--dump-baud C]]
+//                  [--cmd-at H "comando"]...
+//
+// --dump-at manda, H horas depois do boot, o pedido de exportação do
+// log que tools/logdump enviaria; com --serial-file, a captura pode
+// ser remontada por ele. --cmd-at digita uma linha no interpretador
+// de comandos (shell.h) H horas depois do boot; pode se repetir.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "LiquidCrystal_I2C.h"
+#include "sim.h"
+#include "../scheduler.h"
+#include "../logstore.h"
+#include "../episodes.h"
+#include "../archive.h"
+#include "../profile.h"
+#include "../timekeeper.h"
+#include "../power.h"
+#include "../telemetry.h"
+#include "../logexport.h"
+
+// Firmware (codigo-fonte.cpp)
+void setup();
+void loop();
+extern LiquidCrystal_I2C lcdDevice;
+extern int serialMode;
+
+#define UP_BUTTON     11
+#define DOWN_BUTTON   10
+#define SELECT_BUTTON 9
+#define BACK_BUTTON   8
+
+#define DHTPIN        3
+#define RTC_SQW_PIN   7
+
+#define HOLD_MS 80
+
+// Operador simulado: entra na HOME após o boot e, a cada hora,
+// passa um minuto na tela do RTC antes de voltar para a HOME.
+static void scheduleOperator(uint64_t startMs, uint64_t endMs) {
+  uint64_t t = startMs + 2000;
+  simScheduleButton(DOWN_BUTTON,   t,        HOLD_MS);
+  simScheduleButton(SELECT_BUTTON, t + 500,  HOLD_MS);
+
+  for (uint64_t hour = t + 3600000ULL; hour < endMs; hour += 3600000ULL) {
+    simScheduleButton(BACK_BUTTON,   hour,          HOLD_MS);
+    simScheduleButton(DOWN_BUTTON,   hour + 500,    HOLD_MS);
+    simScheduleButton(SELECT_BUTTON, hour + 1000,   HOLD_MS);
+    simScheduleButton(BACK_BUTTON,   hour + 61000,  HOLD_MS);
+    simScheduleButton(UP_BUTTON,     hour + 61500,  HOLD_MS);
+    simScheduleButton(SELECT_BUTTON, hour + 62000,  HOLD_MS);
+  }
+}
+
+// Pedido de exportação do log, precedido de um delimitador
+static void injectDumpRequest(uint16_t offset, uint8_t baud) {
+  TelemetryDumpRequest request;
+  request.offset = offset;
+  request.baud   = baud;
+
+  uint8_t payload[TELEMETRY_PAYLOAD_MAX];
+  uint8_t frame[TELEMETRY_FRAME_MAX + 1];
+  frame[0] = 0x00;
+  size_t n = telemetryFrame(payload, telemetryPackDumpRequest(request, payload), frame + 1);
+  simSerialInject(frame, n + 1);
+}
+
+// Linhas de comando pedidas por --cmd-at
+#define SIM_MAX_COMMANDS 8
+struct SimCommand {
+  uint64_t    atUs;
+  const char* text;
+};
+static SimCommand commands[SIM_MAX_COMMANDS];
+static int        commandCount = 0;
+
+static void injectCommand(const char* text) {
+  char line[128];
+  int  n = snprintf(line, sizeof(line), "%s\n", text);
+  simSerialInject((const uint8_t*)line, n < (int)sizeof(line) ? n : sizeof(line) - 1);
+}
+
+// Duração e volume da exportação pedida por --dump-at
+static uint64_t dumpStartUs = 0, dumpEndUs = 0;
+static uint64_t dumpStartBytes = 0, dumpEndBytes = 0;
+
+static void printReport(double simSeconds, double wallSeconds) {
+  printf("\n==== SIMULAÇÃO ====\n");
+  printf("tempo simulado : %.0f s (%.2f dias)\n", simSeconds, simSeconds / 86400.0);
+  printf("tempo real     : %.2f s (%.0fx)\n", wallSeconds,
+         wallSeconds > 0 ? simSeconds / wallSeconds : 0.0);
+  printf("passadas loop  : %lu (pior %lu us)\n", scheduler.passes(), scheduler.maxPassUs());
+
+  printf("\n==== TAREFAS ====\n");
+  printf("%-8s %10s %8s %8s %10s %10s\n", "tarefa", "execuções", "perdidos", "atrasos", "média us", "máx us");
+  for (int i = 0; i < scheduler.count(); i++) {
+    const Task& t = scheduler.task(i);
+    printf("%-8s %10lu %8lu %8lu %10lu %10lu\n", t.name, t.runs, t.missed, t.lateRuns,
+           t.runs ? t.totalUs / t.runs : 0, t.maxUs);
+  }
+
+  printf("\n==== BARRAMENTOS ====\n");
+  printf("I2C transações : %llu (%.1f/s), %llu bytes\n",
+         (unsigned long long)simStats.i2cTransactions, simStats.i2cTransactions / simSeconds,
+         (unsigned long long)simStats.i2cBytes);
+  printf("I2C ocupação   : %.2f s (%.2f%%)\n", simStats.i2cBusUs / 1e6,
+         100.0 * simStats.i2cBusUs / 1e6 / simSeconds);
+  printf("  LCD          : %llu transações\n", (unsigned long long)simStats.lcdTransactions);
+  printf("  RTC          : %llu transações\n", (unsigned long long)simStats.rtcTransactions);
+  printf("  CGRAM        : %lu glifos enviados\n", lcdDevice.cgramWrites());
+  printf("Serial         : %llu bytes (%.1f B/s), bloqueado %.2f s\n",
+         (unsigned long long)simStats.serialBytes, simStats.serialBytes / simSeconds,
+         simStats.serialStallUs / 1e6);
+  printf("DHT            : %llu leituras, %llu interrupções\n",
+         (unsigned long long)simStats.dhtReads, (unsigned long long)simStats.interrupts);
+  printf("Relógio        : %lu bordas SQW, %u ressincronizações, %u correções\n",
+         (unsigned long)clockTicks(), clockResyncs(), clockCorrections());
+  printf("ADC            : %llu conversões\n", (unsigned long long)simStats.adcReads);
+  printf("Buzzer         : %llu mudanças de tom\n", (unsigned long long)simStats.toneChanges);
+
+  printf("\n==== ENERGIA ====\n");
+  printf("CPU acordada   : %.1f%% (firmware: %.1f%%), %llu despertares\n",
+         100.0 - 100.0 * simStats.sleepUs / 1e6 / simSeconds, powerDutyPermille() / 10.0,
+         (unsigned long long)simStats.wakeups);
+  printf("luz de fundo   : %.1f%% do tempo acesa\n",
+         100.0 * lcdDevice.backlightMicros() / 1e6 / simSeconds);
+  printf("watchdog       : %u interrupções, %llu resets\n", powerWatchdogBites(),
+         (unsigned long long)simStats.watchdogResets);
+
+  printf("\n==== EEPROM ====\n");
+  printf("gravações      : %llu bytes (%.1f/h)\n", (unsigned long long)simStats.eepromWrites,
+         simStats.eepromWrites / (simSeconds / 3600.0));
+  printf("pior célula    : %lu gravações\n", EEPROM.maxCellWrites());
+  if (logTier() == LOG_TIER_EXTERNAL) {
+    printf("AT24C32        : %llu gravações de página, %llu bytes (%.1f/h), pior página %lu\n",
+           (unsigned long long)simStats.at24WriteCycles,
+           (unsigned long long)simStats.at24BytesWritten,
+           simStats.at24BytesWritten / (simSeconds / 3600.0), simAt24MaxPageWrites());
+  }
+
+  // Histórico que ainda pode ser recuperado do log
+  LogReader reader;
+  LogSample sample;
+  unsigned long samples = 0;
+  uint32_t oldest = 0, newest = 0;
+  while (reader.next(sample)) {
+    if (samples == 0 || sample.timestamp < oldest) oldest = sample.timestamp;
+    if (samples == 0 || sample.timestamp > newest) newest = sample.timestamp;
+    samples++;
+  }
+  printf("log            : %lu amostras, %.1f h de histórico, %d blocos na %s\n", samples,
+         samples ? (newest - oldest) / 3600.0 : 0.0, logBlockCount(),
+         logTier() == LOG_TIER_EXTERNAL ? "AT24C32" : "EEPROM interna");
+
+  // Episódios por canal e quantos seguem abertos
+  Episode  episode;
+  unsigned perChannel[ALERT_CHANNELS] = { 0, 0, 0 };
+  unsigned open = 0;
+  for (uint8_t i = 0; i < episodeCount(); i++) {
+    if (!episodeRead(i, episode)) continue;
+    perChannel[episode.channel]++;
+    if (episode.state == EPISODE_OPEN) open++;
+  }
+  printf("episódios      : %u (temp %u, umid %u, luz %u), %u em curso\n", episodeCount(),
+         perChannel[ALERT_CH_TEMP], perChannel[ALERT_CH_HUMD], perChannel[ALERT_CH_LIGHT], open);
+
+  // Arquivo de tendências: períodos fechados ainda legíveis por anel
+  unsigned      stored[ARCHIVE_TIERS] = { 0, 0, 0 };
+  ArchiveRecord record, lastDay;
+  bool          haveDay = false;
+  for (uint8_t tier = 0; tier < ARCHIVE_TIERS; tier++) {
+    ArchiveCursor cursor(tier, 0, 0xFFFFFFFF);
+    while (cursor.next(record)) {
+      if (record.open) continue;
+      stored[tier]++;
+      if (tier == ARCHIVE_DAY) {
+        lastDay = record;
+        haveDay = true;
+      }
+    }
+  }
+  printf("arquivo        : %u/%u minutos, %u/%u horas, %u/%u dias\n",
+         stored[ARCHIVE_MINUTE], archiveSlots(ARCHIVE_MINUTE), stored[ARCHIVE_HOUR],
+         archiveSlots(ARCHIVE_HOUR), stored[ARCHIVE_DAY], archiveSlots(ARCHIVE_DAY));
+  if (haveDay) {
+    printf("último dia     : temp %.1f/%.1f/%.1f °C, umid %.1f/%.1f/%.1f %%, luz %d/%d/%d %% (%u h)\n",
+           lastDay.min[0] / 100.0, lastDay.mean[0] / 100.0, lastDay.max[0] / 100.0,
+           lastDay.min[1] / 100.0, lastDay.mean[1] / 100.0, lastDay.max[1] / 100.0,
+           lastDay.min[2], lastDay.mean[2], lastDay.max[2], lastDay.cover);
+  }
+
+  if (dumpEndUs > dumpStartUs) {
+    printf("exportação     : %llu bytes em %.2f s\n",
+           (unsigned long long)(dumpEndBytes - dumpStartBytes), (dumpEndUs - dumpStartUs) / 1e6);
+  }
+
+#if PROFILE_ENABLED
+  // Perfil visto pelo próprio firmware (profile.h): p99 pela faixa
+  // do histograma, contadores comparados com os da simulação
+  printf("\n==== PERFIL ====\n");
+  printf("%-12s %10s %10s %10s\n", "etapa", "execuções", "p99 us", "máx us");
+  for (uint8_t stage = 0; stage < PROF_STAGES; stage++) {
+    const ProfileStage& st = profileStage(stage);
+    unsigned long total = 0, seen = 0;
+    for (uint8_t b = 0; b < PROFILE_BUCKETS; b++) total += st.buckets[b];
+    uint8_t p99 = 0;
+    for (; p99 < PROFILE_BUCKETS - 1; p99++) {
+      seen += st.buckets[p99];
+      if (seen * 100 >= total * 99) break;
+    }
+    char limit[16];
+    if (p99 == PROFILE_BUCKETS - 1) snprintf(limit, sizeof(limit), ">=%lu", (unsigned long)profileBucketLimit(p99 - 1));
+    else                            snprintf(limit, sizeof(limit), "<%lu", (unsigned long)profileBucketLimit(p99));
+    printf("%-12s %10lu %10s %10lu\n", profileStageName(stage), (unsigned long)st.count, limit,
+           (unsigned long)st.maxUs);
+  }
+  printf("contadores    : I2C %lu (simulado %llu), EEPROM %lu bytes (simulado %llu), AT24C32 %lu ciclos\n",
+         (unsigned long)profileCounter(PROF_COUNT_I2C), (unsigned long long)simStats.i2cTransactions,
+         (unsigned long)profileCounter(PROF_COUNT_EEPROM), (unsigned long long)simStats.eepromWrites,
+         (unsigned long)profileCounter(PROF_COUNT_AT24));
+#endif
+
+  printf("\n==== LCD ====\n");
+  printf("+----------------+\n");
+  printf("|%s|\n", lcdDevice.rowText(0));
+  printf("|%s|\n", lcdDevice.rowText(1));
+  printf("+----------------+\n");
+}
+
+int main(int argc, char** argv) {
+  double   hours  = 24.0 * 7;
+  uint32_t seed   = 12345;
+  bool     withUi = true;
+  bool     withAt24 = true;
+  double   dumpAt   = -1;
+  uint16_t dumpOffset = 0;
+  uint8_t  dumpBaud   = EXPORT_BAUD_MAX_CODE;
+  double   commandAt[SIM_MAX_COMMANDS];
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--days") && i + 1 < argc)       hours = atof(argv[++i]) * 24.0;
+    else if (!strcmp(argv[i], "--hours") && i + 1 < argc) hours = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--seed") && i + 1 < argc)  seed = (uint32_t)strtoul(argv[++i], 0, 10);
+    else if (!strcmp(argv[i], "--serial"))                simSerialOut = stdout;
+    else if (!strcmp(argv[i], "--serial-file") && i + 1 < argc) {
+      simSerialOut = fopen(argv[++i], "wb");
+      if (!simSerialOut) { perror(argv[i]); return 1; }
+    }
+    else if (!strcmp(argv[i], "--binary"))                serialMode = 1;
+    else if (!strcmp(argv[i], "--no-ui"))                 withUi = false;
+    else if (!strcmp(argv[i], "--no-at24c32"))            withAt24 = false;
+    else if (!strcmp(argv[i], "--dump-at") && i + 1 < argc)     dumpAt = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--dump-offset") && i + 1 < argc) dumpOffset = (uint16_t)atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--dump-baud") && i + 1 < argc)   dumpBaud = (uint8_t)atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--cmd-at") && i + 2 < argc && commandCount < SIM_MAX_COMMANDS) {
+      commandAt[commandCount]       = atof(argv[++i]);
+      commands[commandCount++].text = argv[++i];
+    }
+    else {
+      fprintf(stderr, "uso: %s [--days N] [--hours N] [--seed N] [--serial | --serial-file F] "
+                      "[--binary] [--no-ui] [--no-at24c32] "
+                      "[--dump-at H [--dump-offset N] [--dump-baud C]] "
+                      "[--cmd-at H \"comando\"]...\n", argv[0]);
+      return 2;
+    }
+  }
+
+  simSeed(seed);
+  simDhtAttach(DHTPIN);
+  simSqwAttach(RTC_SQW_PIN);
+  simAt24Attach(withAt24);
+  clock_t wallStart = clock();
+
+  setup();
+
+  uint64_t startUs = simMicros();
+  uint64_t endUs   = startUs + (uint64_t)(hours * 3600.0 * 1e6);
+  if (withUi) scheduleOperator(startUs / 1000, endUs / 1000);
+
+  uint64_t dumpUs = dumpAt >= 0 ? startUs + (uint64_t)(dumpAt * 3600.0 * 1e6) : UINT64_MAX;
+  bool     dumping = false;
+  for (int c = 0; c < commandCount; c++) {
+    commands[c].atUs = startUs + (uint64_t)(commandAt[c] * 3600.0 * 1e6);
+  }
+
+  while (simMicros() < endUs) {
+    if (simMicros() >= dumpUs) {
+      injectDumpRequest(dumpOffset, dumpBaud);
+      dumpUs = UINT64_MAX;
+    }
+    for (int c = 0; c < commandCount; c++) {
+      if (simMicros() < commands[c].atUs) continue;
+      injectCommand(commands[c].text);
+      commands[c].atUs = UINT64_MAX;
+    }
+    if (exportActive() != dumping) {
+      dumping = exportActive();
+      if (dumping) { dumpStartUs = simMicros(); dumpStartBytes = simStats.serialBytes; }
+      else         { dumpEndUs   = simMicros(); dumpEndBytes   = simStats.serialBytes; }
+    }
+
+    uint64_t before = simMicros();
+    loop();
+    if (simMicros() == before) {
+      // Nada consumiu tempo: pula direto para a próxima liberação
+      unsigned long wait = scheduler.msUntilNextRun();
+      if (wait == 0) wait = 1;
+      simAdvanceTo(((uint64_t)millis() + wait) * 1000);
+    }
+  }
+
+  double wallSeconds = (double)(clock() - wallStart) / CLOCKS_PER_SEC;
+  if (simSerialOut && simSerialOut != stdout) fclose(simSerialOut);
+  simSerialOut = NULL;
+  printReport((endUs - startUs) / 1e6, wallSeconds);
+  return 0;
+}
@@ -0,0 +1,370 @@
+#include "sim.h"
+
+#include <math.h>
+#include <set>
+
+#include "Arduino.h"
+#include "avr/io.h"
+#include "avr/sleep.h"
+
+SimStats simStats;
+FILE*    simSerialOut  = NULL;
+
+static uint64_t virtualMicros = 0;
+static int      pinLevel[SIM_NUM_PINS];
+static int      pinModes[SIM_NUM_PINS];
+static bool     pinsReady = false;
+static int      toneFrequency = 0;
+static uint32_t rngState = 12345;
+
+// ISRs das interrupções externas INT0 (pino 2) e INT1 (pino 3)
+static void (*extIsr[2])(void);
+
+// Modelo do DHT11
+static int      dhtPin        = -1;
+static bool     dhtDrivenLow  = false;
+static uint64_t dhtLowSinceUs = 0;
+
+// Saída SQW do DS3231
+static int      sqwPin    = -1;
+static bool     sqwOn     = false;
+static uint64_t sqwNextUs = 0;
+static int      sqwLevel  = HIGH;
+
+// Sono da CPU
+static uint8_t  sleepMode    = SLEEP_MODE_IDLE;
+static bool     sleepEnabled = false;
+
+// Barramento I2C a 100 kHz: 10 us por bit
+#define I2C_BIT_US 10
+
+struct PinEvent {
+  uint64_t atUs;
+  int      pin;
+  int      level;
+  bool operator<(const PinEvent& other) const { return atUs < other.atUs; }
+};
+
+// Ordenados por instante; eventos simultâneos ficam na ordem de inserção
+static std::multiset<PinEvent> pinEvents;
+
+static void initPins() {
+  if (pinsReady) return;
+  for (int i = 0; i < SIM_NUM_PINS; i++) {
+    pinLevel[i] = HIGH;   // botões com pull-up ficam em HIGH
+    pinModes[i] = INPUT;
+  }
+  pinsReady = true;
+}
+
+static void schedulePinLevel(int pin, uint64_t atUs, int level) {
+  PinEvent event = { atUs, pin, level };
+  pinEvents.insert(event);
+}
+
+// INT0 no pino 2, INT1 no pino 3; -1 nos demais
+static int extInterrupt(int pin) {
+  return pin == 2 ? 0 : (pin == 3 ? 1 : -1);
+}
+
+// Executa o pedido pendente em EIFR, se a interrupção está ligada
+static void runExternal(int n) {
+  if (!(EIFR & _BV(n)) || !(EIMSK & _BV(n)) || !extIsr[n]) return;
+  EIFR = _BV(n);
+  simStats.interrupts++;
+  extIsr[n]();
+}
+
+// Borda num pino de INT0/INT1, vinda de fora ou do próprio firmware
+// (pino como saída): no sentido de EICRA, marca o pedido em EIFR
+static void externalEdge(int pin, int level) {
+  int n = extInterrupt(pin);
+  if (n < 0) return;
+  uint8_t sense = (EICRA >> (2 * n)) & 0x03;
+  if (sense == CHANGE || (sense == FALLING && level == LOW) || (sense == RISING && level == HIGH)) {
+    EIFR.bits |= _BV(n);
+    runExternal(n);
+  }
+}
+
+// Nível imposto de fora (botão, sensor): dispara a ISR do pino, se houver
+static void driveLevel(int pin, int level) {
+  int old = pinLevel[pin];
+  pinLevel[pin] = level;
+  if (old == level) return;
+
+  simAvrPinChanged(pin);
+  externalEdge(pin, level);
+}
+
+/************************************************************
+ *                     RELÓGIO VIRTUAL                      *
+ ************************************************************/
+uint64_t simMicros() {
+  return virtualMicros;
+}
+
+void simAdvanceMicros(uint64_t us) {
+  // Aplica cada borda e cada evento de periférico no seu instante,
+  // para a ISR ver o micros() certo
+  uint64_t target = virtualMicros + us;
+  for (;;) {
+    uint64_t nextPin = pinEvents.empty() ? UINT64_MAX : pinEvents.begin()->atUs;
+    uint64_t nextAvr = simAvrNextEvent();
+    uint64_t nextSqw = sqwOn ? sqwNextUs : UINT64_MAX;
+    uint64_t next    = nextPin < nextAvr ? nextPin : nextAvr;
+    if (nextSqw < next) next = nextSqw;
+    if (next > target) break;
+    if (next > virtualMicros) virtualMicros = next;
+
+    if (next == nextSqw) {
+      // Onda quadrada gerada sob demanda, sem encher a fila de bordas
+      sqwLevel   = sqwLevel == HIGH ? LOW : HIGH;
+      sqwNextUs += 500000;
+      driveLevel(sqwPin, sqwLevel);
+    }
+    else if (next == nextPin) {
+      PinEvent event = *pinEvents.begin();
+      pinEvents.erase(pinEvents.begin());
+      driveLevel(event.pin, event.level);
+    }
+    else {
+      simAvrRunEvent();
+    }
+  }
+  virtualMicros = target;
+}
+
+void simAdvanceTo(uint64_t us) {
+  if (us > virtualMicros) simAdvanceMicros(us - virtualMicros);
+}
+
+/************************************************************
+ *                      SONO DA CPU                         *
+ ************************************************************/
+// Estouro do Timer0 (millis) a cada 1024 us, e o custo da ISR dele
+#define TIMER0_OVERFLOW_US 1024
+#define TIMER0_ISR_US      4
+
+void simSleepMode(uint8_t mode) {
+  sleepMode = mode;
+}
+
+void simSleepEnable(bool enabled) {
+  sleepEnabled = enabled;
+}
+
+void simSleepCpu() {
+  // Só o modo IDLE: os timers seguem e qualquer interrupção acorda
+  if (!sleepEnabled) return;
+
+  // Próxima interrupção: uma borda, um periférico ou o Timer0
+  uint64_t wake = (virtualMicros / TIMER0_OVERFLOW_US + 1) * TIMER0_OVERFLOW_US;
+  uint64_t next = simAvrNextEvent();
+  if (next < wake) wake = next;
+  if (!pinEvents.empty() && pinEvents.begin()->atUs < wake) wake = pinEvents.begin()->atUs;
+  if (sqwOn && sqwNextUs < wake) wake = sqwNextUs;
+  if (wake < virtualMicros) wake = virtualMicros;
+
+  simStats.sleepUs += wake - virtualMicros;
+  simStats.wakeups++;
+  simAdvanceMicros(wake - virtualMicros);
+  if (wake % TIMER0_OVERFLOW_US == 0) simAdvanceMicros(TIMER0_ISR_US);
+}
+
+/************************************************************
+ *                          PINOS                           *
+ ************************************************************/
+int simPinLevel(int pin) {
+  initPins();
+  if (pin < 0 || pin >= SIM_NUM_PINS) return LOW;
+  return pinLevel[pin];
+}
+
+static void dhtRespond();
+
+void simSetPinLevel(int pin, int level) {
+  initPins();
+  if (pin < 0 || pin >= SIM_NUM_PINS) return;
+  int old = pinLevel[pin];
+  pinLevel[pin] = level;
+  if (old != level) externalEdge(pin, level);
+  if (pin == dhtPin && pinModes[pin] == OUTPUT && level == LOW && !dhtDrivenLow) {
+    dhtDrivenLow  = true;
+    dhtLowSinceUs = virtualMicros;
+  }
+}
+
+int simPinMode(int pin) {
+  initPins();
+  if (pin < 0 || pin >= SIM_NUM_PINS) return INPUT;
+  return pinModes[pin];
+}
+
+void simSetPinMode(int pin, int mode) {
+  initPins();
+  if (pin < 0 || pin >= SIM_NUM_PINS) return;
+  pinModes[pin] = mode;
+  if (pin == dhtPin && mode != OUTPUT && dhtDrivenLow) {
+    // Linha solta: o pull-up a leva a HIGH e o sensor responde
+    dhtDrivenLow  = false;
+    pinLevel[pin] = HIGH;
+    if (virtualMicros - dhtLowSinceUs >= 18000) dhtRespond();
+  }
+}
+
+int simToneFrequency() {
+  return toneFrequency;
+}
+
+void simSetTone(int frequency) {
+  if (frequency != toneFrequency) simStats.toneChanges++;
+  toneFrequency = frequency;
+}
+
+void simScheduleButton(int pin, uint64_t atMs, uint64_t holdMs) {
+  initPins();
+  schedulePinLevel(pin, atMs * 1000, LOW);
+  schedulePinLevel(pin, (atMs + holdMs) * 1000, HIGH);
+}
+
+/************************************************************
+ *                      INTERRUPÇÕES                        *
+ ************************************************************/
+// Como o attachInterrupt() do núcleo AVR: não limpa EIFR, então um
+// pedido antigo dispara a ISR na hora
+void simAttachInterrupt(int pin, void (*isr)(void), int mode) {
+  int n = extInterrupt(pin);
+  if (n < 0) return;
+  extIsr[n] = isr;
+  EICRA     = (uint8_t)((EICRA & ~(0x03 << (2 * n))) | ((mode & 0x03) << (2 * n)));
+  EIMSK    |= _BV(n);
+  runExternal(n);
+}
+
+void simDetachInterrupt(int pin) {
+  int n = extInterrupt(pin);
+  if (n < 0) return;
+  EIMSK    &= ~_BV(n);
+  extIsr[n] = NULL;
+}
+
+/************************************************************
+ *                    SAÍDA SQW DO DS3231                   *
+ ************************************************************/
+void simSqwAttach(int pin) {
+  initPins();
+  sqwPin = pin;
+}
+
+void simSqwStart(uint64_t secondUs) {
+  if (sqwPin < 0) return;
+  // Próxima virada de segundo a partir de agora: borda de descida
+  uint64_t next = secondUs;
+  if (next <= virtualMicros) next += (virtualMicros - next) / 1000000 * 1000000 + 1000000;
+  // Entre a subida e a descida, a linha está em HIGH
+  sqwLevel  = next - virtualMicros > 500000 ? LOW : HIGH;
+  sqwNextUs = sqwLevel == LOW ? next - 500000 : next;
+  sqwOn     = true;
+  driveLevel(sqwPin, sqwLevel);
+}
+
+void simSqwStop() {
+  if (sqwPin < 0) return;
+  sqwOn = false;
+  driveLevel(sqwPin, HIGH);
+}
+
+/************************************************************
+ *                      SENSOR DHT11                        *
+ ************************************************************/
+void simDhtAttach(int pin) {
+  initPins();
+  dhtPin = pin;
+}
+
+// Agenda as bordas de uma resposta completa a partir de agora
+static void dhtRespond() {
+  // O DHT11 só tem resolução de 1 unidade
+  float   t    = floorf(simTemperatureC() + 0.5f);
+  float   h    = floorf(simHumidity() + 0.5f);
+  uint8_t data[5];
+  data[0] = (uint8_t)h;
+  data[1] = 0;
+  data[2] = (uint8_t)fabsf(t);
+  data[3] = t < 0 ? 0x80 : 0;
+  data[4] = (uint8_t)(data[0] + data[1] + data[2] + data[3]);
+
+  uint64_t at = virtualMicros + 30;
+  schedulePinLevel(dhtPin, at, LOW);   at += 80;
+  schedulePinLevel(dhtPin, at, HIGH);  at += 80;
+  for (int bit = 0; bit < 40; bit++) {
+    bool one = data[bit / 8] & (0x80 >> (bit % 8));
+    schedulePinLevel(dhtPin, at, LOW);   at += 50;
+    schedulePinLevel(dhtPin, at, HIGH);  at += one ? 70 : 27;
+  }
+  schedulePinLevel(dhtPin, at, LOW);   at += 50;
+  schedulePinLevel(dhtPin, at, HIGH);
+
+  simStats.dhtReads++;
+}
+
+/************************************************************
+ *                        AMBIENTE                          *
+ ************************************************************/
+void simSeed(uint32_t seed) {
+  rngState = seed ? seed : 1;
+}
+
+uint32_t simRandom() {
+  // xorshift32
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+
+static float noise(float amplitude) {
+  return amplitude * (((simRandom() % 2001) / 1000.0f) - 1.0f);
+}
+
+// Fração do dia (0..1) no relógio virtual
+static float dayPhase() {
+  const double dayUs = 86400.0 * 1e6;
+  return (float)(fmod((double)virtualMicros, dayUs) / dayUs);
+}
+
+float simTemperatureC() {
+  // Mínima às 03h, máxima às 15h: 15..29 °C
+  return 22.0f + 7.0f * sinf(2.0f * (float)M_PI * (dayPhase() - 0.375f)) + noise(0.4f);
+}
+
+float simHumidity() {
+  // Umidade em oposição de fase à temperatura: 33..57 %
+  return 45.0f - 12.0f * sinf(2.0f * (float)M_PI * (dayPhase() - 0.375f)) + noise(1.0f);
+}
+
+int simLightRaw() {
+  // Dia entre 06h e 18h
+  float phase = dayPhase();
+  float level = 0.05f;
+  if (phase > 0.25f && phase < 0.75f) {
+    level = 0.2f + 0.7f * sinf((float)M_PI * (phase - 0.25f) * 2.0f);
+  }
+  int raw = 40 + (int)(level * 910.0f + noise(6.0f));
+  if (raw < 0)    raw = 0;
+  if (raw > 1023) raw = 1023;
+  return raw;
+}
+
+/************************************************************
+ *                          I2C                             *
+ ************************************************************/
+void simI2cTransaction(int bytes) {
+  // START + (endereço + dados) * 9 bits + STOP
+  uint64_t busUs = (uint64_t)(2 + 9 * (bytes + 1)) * I2C_BIT_US;
+  simStats.i2cTransactions++;
+  simStats.i2cBytes += bytes;
+  simStats.i2cBusUs += busUs;
+  simAdvanceMicros(busUs);
+}
@@ -0,0 +1,111 @@
+/************************************************************
+ *         SIMULAÇÃO NO HOST: RELÓGIO, PINOS E AMBIENTE      *
+ ************************************************************/
+// Estado compartilhado pelas implementações de host da HAL
+// (Arduino.h, LiquidCrystal_I2C.h, RTClib.h, EEPROM.h) e pelos
+// modelos de dispositivos ligados aos pinos (sensor DHT11).
+// O tempo é virtual: só avança quando a HAL modela o custo de
+// uma operação de E/S ou quando o driver da simulação o avança.
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define SIM_NUM_PINS 20
+
+// Contadores acumulados durante a simulação
+struct SimStats {
+  uint64_t i2cTransactions;
+  uint64_t i2cBytes;
+  uint64_t i2cBusUs;
+  uint64_t lcdTransactions;
+  uint64_t rtcTransactions;
+  uint64_t eepromWrites;
+  uint64_t eepromReads;
+  uint64_t at24WriteCycles;  // gravações de página na AT24C32
+  uint64_t at24BytesWritten;
+  uint64_t at24BytesRead;
+  uint64_t serialBytes;
+  uint64_t serialStallUs;    // tempo bloqueado com o buffer TX cheio
+  uint64_t dhtReads;
+  uint64_t interrupts;       // ISRs de pino executadas
+  uint64_t adcReads;
+  uint64_t toneChanges;
+  uint64_t watchdogResets;   // estouros que reiniciariam o MCU
+  uint64_t sleepUs;          // tempo com a CPU parada em sleep_cpu()
+  uint64_t wakeups;
+};
+
+extern SimStats simStats;
+
+// ==== RELÓGIO VIRTUAL ====
+uint64_t simMicros();
+void     simAdvanceMicros(uint64_t us);
+void     simAdvanceTo(uint64_t us);
+
+// ==== PINOS ====
+int  simPinLevel(int pin);
+void simSetPinLevel(int pin, int level);   // entradas vistas pelo firmware
+int  simPinMode(int pin);
+void simSetPinMode(int pin, int mode);
+int  simToneFrequency();
+void simSetTone(int frequency);
+
+// ==== INTERRUPÇÕES ====
+// Chamadas por attachInterrupt/detachInterrupt (modo CHANGE/FALLING/RISING).
+// Só INT0 (pino 2) e INT1 (pino 3), com EICRA/EIMSK/EIFR de avr/io.h
+void simAttachInterrupt(int pin, void (*isr)(void), int mode);
+void simDetachInterrupt(int pin);
+
+// ==== PERIFÉRICOS INTERNOS (host/avr.cpp) ====
+// Instante do próximo evento dos registradores simulados (UINT64_MAX
+// se nenhum periférico está ativo) e execução desse evento
+uint64_t simAvrNextEvent();
+void     simAvrRunEvent();
+// Borda num pino de entrada: gera a interrupção de mudança de pino
+// (PCINTn_vect) se o pino estiver habilitado em PCMSKn/PCICR
+void     simAvrPinChanged(int pin);
+
+// ==== SENSOR DHT11 ====
+// Liga o modelo do sensor à linha de dados 'pin': depois de um pulso
+// LOW de pelo menos 18 ms, quando o firmware solta a linha, o modelo
+// agenda as bordas da resposta (80/80 us e 40 bits de 50 us + 27/70 us)
+void simDhtAttach(int pin);
+
+// ==== SAÍDA SQW DO DS3231 ====
+// Liga a saída SQW do RTC (dreno aberto, com pull-up) ao pino 'pin'.
+// Com a onda de 1 Hz habilitada pelo RTC simulado, o pino desce a
+// cada virada de segundo do RTC e sobe meio segundo depois.
+void simSqwAttach(int pin);
+void simSqwStart(uint64_t secondUs);   // uma virada de segundo do RTC
+void simSqwStop();
+
+// ==== BOTÕES ====
+// Agenda um toque: o pino vai a LOW em atMs e volta a HIGH após holdMs
+void simScheduleButton(int pin, uint64_t atMs, uint64_t holdMs);
+
+// ==== AMBIENTE ====
+// Modelo determinístico: ciclo diário de temperatura, umidade e luz
+void   simSeed(uint32_t seed);
+float  simTemperatureC();
+float  simHumidity();
+int    simLightRaw();      // leitura crua do ADC (0..1023)
+uint32_t simRandom();
+
+// ==== I2C ====
+// Contabiliza uma transação de barramento e avança o relógio
+void simI2cTransaction(int bytes);
+
+// ==== EEPROM EXTERNA AT24C32 (host/Wire.cpp) ====
+// Liga (apagada) ou remove a AT24C32 do barramento, no endereço 0x57
+void          simAt24Attach(bool present);
+unsigned long simAt24MaxPageWrites();
+
+// ==== SERIAL ====
+// Destino dos bytes transmitidos pelo firmware (NULL = descarta)
+extern FILE* simSerialOut;
+// Bytes enviados ao firmware, recebidos à taxa do baud rate atual
+void simSerialInject(const uint8_t* data, size_t len);
+
+#endif
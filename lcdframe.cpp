@@ -0,0 +1,63 @@
+#include "lcdframe.h"
+
+#include "profile.h"
+
+LcdFrame::LcdFrame(LiquidCrystal_I2C& device)
+  : device(device), col(0), row(0), dirty(false) {
+  memset(frame, ' ', sizeof(frame));
+  memset(shown, ' ', sizeof(shown));    // display recém-inicializado
+}
+
+void LcdFrame::clear() {
+  memset(frame, ' ', sizeof(frame));
+  col   = 0;
+  row   = 0;
+  dirty = true;
+}
+
+void LcdFrame::setCursor(uint8_t col, uint8_t row) {
+  this->col = col;
+  this->row = row < LCD_FRAME_ROWS ? row : LCD_FRAME_ROWS - 1;
+}
+
+size_t LcdFrame::write(uint8_t value) {
+  // Como no HD44780, o que passa da última coluna não aparece
+  if (col < LCD_FRAME_COLS) {
+    if (frame[row][col] != value) {
+      frame[row][col] = value;
+      dirty = true;
+    }
+  }
+  col++;
+  return 1;
+}
+
+void LcdFrame::flush() {
+  if (!dirty) return;
+
+  for (uint8_t r = 0; r < LCD_FRAME_ROWS; r++) {
+    uint8_t c = 0;
+    while (c < LCD_FRAME_COLS) {
+      if (frame[r][c] == shown[r][c]) {
+        c++;
+        continue;
+      }
+      // Um setCursor para toda a sequência de células alteradas
+      device.setCursor(c, r);
+      PROFILE_COUNT(PROF_COUNT_I2C, PROFILE_LCD_I2C_PER_BYTE);
+      while (c < LCD_FRAME_COLS && frame[r][c] != shown[r][c]) {
+        device.write(frame[r][c]);
+        PROFILE_COUNT(PROF_COUNT_I2C, PROFILE_LCD_I2C_PER_BYTE);
+        shown[r][c] = frame[r][c];
+        c++;
+      }
+    }
+  }
+  dirty = false;
+}
+
+void LcdFrame::invalidate() {
+  memset(shown, ' ', sizeof(shown));
+  device.clear();
+  dirty = true;
+}
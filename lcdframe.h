@@ -0,0 +1,46 @@
+/************************************************************
+ *          FRAMEBUFFER DO LCD (ENVIO POR DIFERENÇA)        *
+ ************************************************************/
+// O firmware desenha numa cópia da tela em RAM, com a mesma
+// interface de texto da LiquidCrystal_I2C (clear, setCursor, print,
+// write). flush() compara essa cópia com o que já está no display e
+// envia só as células que mudaram: cada sequência de células
+// alteradas vizinhas numa linha custa um único setCursor.
+//
+// clear() aqui não vai ao display (o comando real leva 2 ms e faz a
+// tela piscar); só as células que deixaram de estar vazias são
+// reescritas no próximo flush().
+#ifndef LCDFRAME_H
+#define LCDFRAME_H
+
+#include <Arduino.h>
+#include <LiquidCrystal_I2C.h>
+
+#define LCD_FRAME_COLS 16
+#define LCD_FRAME_ROWS 2
+
+class LcdFrame : public Print {
+public:
+  LcdFrame(LiquidCrystal_I2C& device);
+
+  void clear();
+  void setCursor(uint8_t col, uint8_t row);
+  virtual size_t write(uint8_t value);
+  using Print::write;
+
+  // Envia as diferenças ao display; não faz nada se nada mudou
+  void flush();
+  // Limpa o display de fato e redesenha a cópia inteira no próximo
+  // flush() (por exemplo, depois de reinicializar o LCD)
+  void invalidate();
+
+private:
+  LiquidCrystal_I2C& device;
+  uint8_t frame[LCD_FRAME_ROWS][LCD_FRAME_COLS];   // conteúdo desejado
+  uint8_t shown[LCD_FRAME_ROWS][LCD_FRAME_COLS];   // conteúdo no display
+  uint8_t col;
+  uint8_t row;
+  bool    dirty;
+};
+
+#endif
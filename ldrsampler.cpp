@@ -0,0 +1,63 @@
+#include "ldrsampler.h"
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#include "ring.h"
+
+// Timer1 com prescaler 64: 250 kHz a 16 MHz
+#define LDR_TIMER_HZ  (F_CPU / 64)
+
+static SpscRing<uint16_t, LDR_QUEUE_SIZE> samples;
+
+// Estado da ISR
+static volatile uint16_t accumulator = 0;
+static volatile uint8_t  conversions = 0;
+
+void ldrBegin(uint8_t channel) {
+  cli();
+
+  // ADC: referência AVcc, canal escolhido, clock 16 MHz/128 = 125 kHz
+  // (104 us por conversão), disparo pela comparação B do Timer1
+  ADMUX  = _BV(REFS0) | (channel & 0x0F);
+  ADCSRB = _BV(ADTS2) | _BV(ADTS0);
+  DIDR0 |= _BV(channel);            // desliga o buffer digital do pino
+  ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) |
+           _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+
+  // Timer1 em CTC (TOP = OCR1A); OCR1B no mesmo valor gera o gatilho
+  TCCR1A = 0;
+  TCCR1B = 0;
+  TCNT1  = 0;
+  OCR1A  = LDR_TIMER_HZ / LDR_CONVERSION_HZ - 1;
+  OCR1B  = OCR1A;
+  TIFR1  = _BV(OCF1B);
+  TCCR1B = _BV(WGM12) | _BV(CS11) | _BV(CS10);
+
+  accumulator = 0;
+  conversions = 0;
+  sei();
+}
+
+bool ldrRead(uint16_t& raw) {
+  return samples.pop(raw);
+}
+
+uint8_t ldrDropped() {
+  return samples.dropped();
+}
+
+ISR(ADC_vect) {
+  // O gatilho seguinte só acontece com a flag OCF1B limpa
+  TIFR1 = _BV(OCF1B);
+
+  uint16_t sum = accumulator + ADC;
+  uint8_t  n   = conversions + 1;
+  if (n == LDR_OVERSAMPLE) {
+    samples.push(sum >> LDR_EXTRA_BITS);
+    sum = 0;
+    n   = 0;
+  }
+  accumulator = sum;
+  conversions = n;
+}
@@ -0,0 +1,29 @@
+/************************************************************
+ *        AMOSTRAGEM DO LDR POR TIMER, ADC E INTERRUPÇÃO    *
+ ************************************************************/
+// O Timer1, em modo CTC, gera um evento de comparação B a cada
+// 1/LDR_CONVERSION_HZ s, e esse evento dispara a conversão do ADC
+// (auto-trigger). A ISR do ADC soma LDR_OVERSAMPLE conversões e
+// entrega uma amostra decimada de 12 bits numa fila SPSC: 4^2 = 16
+// conversões de 10 bits ganham 2 bits de resolução e reduzem o ruído
+// em 4x. O loop só lê amostras prontas, igualmente espaçadas, sem
+// esperar nenhuma conversão.
+#ifndef LDRSAMPLER_H
+#define LDRSAMPLER_H
+
+#include <Arduino.h>
+
+#define LDR_EXTRA_BITS      2                          // bits ganhos por sobreamostragem
+#define LDR_OVERSAMPLE      (1 << (2 * LDR_EXTRA_BITS)) // 16 conversões por amostra
+#define LDR_SAMPLE_HZ       10                         // amostras decimadas por segundo
+#define LDR_CONVERSION_HZ   (LDR_SAMPLE_HZ * LDR_OVERSAMPLE)
+#define LDR_RESOLUTION_BITS (10 + LDR_EXTRA_BITS)
+#define LDR_QUEUE_SIZE      8
+
+// Configura Timer1 + ADC no canal 'channel' (0 = A0) e começa a amostrar
+void     ldrBegin(uint8_t channel);
+// Próxima amostra de 12 bits (0..4095); false se não há nenhuma
+bool     ldrRead(uint16_t& raw);
+uint8_t  ldrDropped();      // amostras perdidas com a fila cheia
+
+#endif
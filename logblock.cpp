@@ -0,0 +1,162 @@
+#include "logblock.h"
+
+// Layout do cabeçalho
+#define HDR_SEQ   0
+#define HDR_TIME  2
+#define HDR_TEMP  6
+#define HDR_HUMD  8
+#define HDR_LUM   10
+#define HDR_CRC   11
+
+/************************************************************
+ *                 CRC, ZIG-ZAG E VARINT                    *
+ ************************************************************/
+// CRC-8 (polinômio 0x31, início 0xFF): rejeita blocos todo 0x00 ou 0xFF
+uint8_t crc8(uint8_t crc, uint8_t data) {
+  crc ^= data;
+  for (int i = 0; i < 8; i++) {
+    crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+  }
+  return crc;
+}
+
+uint8_t crc8Buffer(const uint8_t* data, int len) {
+  uint8_t crc = 0xFF;
+  for (int i = 0; i < len; i++) crc = crc8(crc, data[i]);
+  return crc;
+}
+
+static uint32_t zigzag(int32_t value) {
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value) {
+  return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// 7 bits por byte, bit 7 indica continuação
+static int putVarint(uint8_t* out, uint32_t value) {
+  int len = 0;
+  while (value >= 0x80) {
+    out[len++] = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  out[len++] = (uint8_t)value;
+  return len;
+}
+
+// Lê um varint sem passar de 'end'; devolve 0 se estiver truncado
+static int getVarint(const uint8_t* block, int pos, int end, uint32_t& value) {
+  value = 0;
+  for (int len = 0; len < 5 && pos + len < end; len++) {
+    uint8_t b = block[pos + len];
+    value |= (uint32_t)(b & 0x7F) << (7 * len);
+    if (!(b & 0x80)) return len + 1;
+  }
+  return 0;
+}
+
+/************************************************************
+ *                  CABEÇALHO E REGISTROS                   *
+ ************************************************************/
+static uint16_t get16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void put16(uint8_t* p, uint16_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+void logBuildHeader(uint8_t* header, uint16_t seq, const LogSample& sample) {
+  put16(header + HDR_SEQ,      seq);
+  put16(header + HDR_TIME,     (uint16_t)sample.timestamp);
+  put16(header + HDR_TIME + 2, (uint16_t)(sample.timestamp >> 16));
+  put16(header + HDR_TEMP,     (uint16_t)sample.temp);
+  put16(header + HDR_HUMD,     (uint16_t)sample.humd);
+  header[HDR_LUM] = (uint8_t)(int8_t)sample.lum;
+  header[HDR_CRC] = crc8Buffer(header, HDR_CRC);
+}
+
+bool logParseHeader(const uint8_t* block, uint16_t& seq, LogSample& sample) {
+  if (crc8Buffer(block, HDR_CRC) != block[HDR_CRC]) return false;
+
+  seq              = get16(block + HDR_SEQ);
+  sample.timestamp = get16(block + HDR_TIME) | ((uint32_t)get16(block + HDR_TIME + 2) << 16);
+  sample.temp      = (int16_t)get16(block + HDR_TEMP);
+  sample.humd      = (int16_t)get16(block + HDR_HUMD);
+  sample.lum       = (int8_t)block[HDR_LUM];
+  return true;
+}
+
+bool logBodyValid(const uint8_t* block) {
+  uint8_t stored = block[LOG_BODY_END];
+  return stored == LOG_ERASED ||
+         stored == crc8Buffer(block + LOG_HEADER_SIZE, LOG_BODY_END - LOG_HEADER_SIZE);
+}
+
+// Aplica o código de 2 bits de um canal; devolve 0 se truncado
+static int decodeDelta(const uint8_t* block, uint8_t code, int16_t step, int& pos, int16_t& value) {
+  switch (code) {
+    case LOG_CODE_UP:   value += step; return 1;
+    case LOG_CODE_DOWN: value -= step; return 1;
+    case LOG_CODE_VARINT: {
+      uint32_t raw;
+      int n = getVarint(block, pos, LOG_BODY_END, raw);
+      pos  += n;
+      value += unzigzag(raw);
+      return n;
+    }
+  }
+  return 1;
+}
+
+int logDecodeRecord(const uint8_t* block, int offset, LogSample& sample) {
+  if (offset >= LOG_BODY_END) return 0;
+  uint8_t flags = block[offset];
+  if (flags & 0x80) return 0;            // 0xFF: fim dos registros
+
+  int       pos     = offset + 1;
+  uint32_t  minutes = 1;
+  int       n       = 1;
+  LogSample next    = sample;
+
+  if (flags & LOG_FLAG_MINUTES) {
+    n    = getVarint(block, pos, LOG_BODY_END, minutes);
+    pos += n;
+  }
+  if (n) n = decodeDelta(block, (flags >> LOG_SHIFT_TEMP) & 3, LOG_TEMP_STEP, pos, next.temp);
+  if (n) n = decodeDelta(block, (flags >> LOG_SHIFT_HUMD) & 3, LOG_HUMD_STEP, pos, next.humd);
+  if (n) n = decodeDelta(block, (flags >> LOG_SHIFT_LUM)  & 3, LOG_LUM_STEP,  pos, next.lum);
+  if (n == 0) return 0;
+
+  next.timestamp = (sample.timestamp / 60 + minutes) * 60;
+  sample = next;
+  return pos - offset;
+}
+
+// Código de 2 bits para um canal; grava o varint se necessário
+static uint8_t encodeDelta(int32_t delta, int32_t step, uint8_t* out, int& len) {
+  if (delta == 0)     return LOG_CODE_SAME;
+  if (delta == step)  return LOG_CODE_UP;
+  if (delta == -step) return LOG_CODE_DOWN;
+  len += putVarint(out + len, zigzag(delta));
+  return LOG_CODE_VARINT;
+}
+
+int logEncodeRecord(const LogSample& sample, const LogSample& last, uint8_t* record) {
+  uint32_t minutes = sample.timestamp / 60 - last.timestamp / 60;
+  uint8_t  flags   = 0;
+  int      len     = 1;
+
+  if (minutes != 1) {
+    flags |= LOG_FLAG_MINUTES;
+    len   += putVarint(record + len, minutes);
+  }
+  flags |= encodeDelta((int32_t)sample.temp - last.temp, LOG_TEMP_STEP, record, len) << LOG_SHIFT_TEMP;
+  flags |= encodeDelta((int32_t)sample.humd - last.humd, LOG_HUMD_STEP, record, len) << LOG_SHIFT_HUMD;
+  flags |= encodeDelta((int32_t)sample.lum  - last.lum,  LOG_LUM_STEP,  record, len) << LOG_SHIFT_LUM;
+
+  record[0] = flags;
+  return len;
+}
@@ -0,0 +1,75 @@
+/************************************************************
+ *              FORMATO DOS BLOCOS DO LOG                   *
+ ************************************************************/
+// O log é dividido em blocos de LOG_BLOCK_SIZE bytes. Cada bloco
+// começa com uma amostra absoluta e segue com registros delta, até o
+// primeiro byte apagado (0xFF):
+//
+//   cabeçalho: [seq u16][timestamp u32][temp i16][umid i16][lum i8][crc8]
+//   registro : [flags] [Δminutos varint]? [Δtemp]? [Δumid]? [Δlum]?
+//   último byte: crc8 do corpo, gravado quando o bloco é fechado
+//
+// flags: dois bits por canal (bits 0-1 temp, 2-3 umid, 4-5 lum):
+// 00 = igual, 01 = +1 passo, 10 = -1 passo, 11 = delta zig-zag
+// varint a seguir. Bit 6 = Δminutos presente (senão, 1 minuto após
+// o anterior); bit 7 sempre 0. Um registro sem mudanças ou com
+// variações de um passo ocupa um único byte.
+//
+// Este módulo só codifica e decodifica blocos em memória; não
+// depende da HAL e é compilado também pelas ferramentas de host
+// (tools/logdump), que decodificam uma cópia bruta do log.
+#ifndef LOGBLOCK_H
+#define LOGBLOCK_H
+
+#include <stdint.h>
+
+#define LOG_BLOCK_SIZE     32
+#define LOG_HEADER_SIZE    12
+#define LOG_BODY_END       (LOG_BLOCK_SIZE - 1)   // posição do crc do corpo
+#define LOG_RECORD_MAX     14     // flags + 5 (Δmin) + 3 + 3 + 3
+
+// Códigos de 2 bits por canal
+#define LOG_CODE_SAME      0
+#define LOG_CODE_UP        1
+#define LOG_CODE_DOWN      2
+#define LOG_CODE_VARINT    3
+#define LOG_SHIFT_TEMP     0
+#define LOG_SHIFT_HUMD     2
+#define LOG_SHIFT_LUM      4
+#define LOG_FLAG_MINUTES   0x40
+#define LOG_ERASED         0xFF
+
+// Passo de um código ±1: o DHT11 lê graus e por cento inteiros, então
+// a média de um minuto para o seguinte anda quase sempre de 1 em 1
+// (com 0,1 uma variação de 1 °C custava 2 bytes de varint)
+#define LOG_TEMP_STEP      100    // 1 °C
+#define LOG_HUMD_STEP      100    // 1 %
+#define LOG_LUM_STEP       1      // 1 %
+
+// Temperatura e umidade em centésimos; luminosidade em %
+struct LogSample {
+  uint32_t timestamp;
+  int16_t  temp;
+  int16_t  humd;
+  int16_t  lum;
+};
+
+// CRC-8 (polinômio 0x31, início 0xFF) dos blocos do log, também
+// usado por outros blocos gravados na EEPROM
+uint8_t crc8(uint8_t crc, uint8_t data);
+uint8_t crc8Buffer(const uint8_t* data, int len);
+
+// Cabeçalho de LOG_HEADER_SIZE bytes, com o crc
+void logBuildHeader(uint8_t* header, uint16_t seq, const LogSample& sample);
+// Valida e decodifica o cabeçalho de um bloco
+bool logParseHeader(const uint8_t* block, uint16_t& seq, LogSample& sample);
+// Corpo íntegro: bloco ainda aberto (sem crc) ou crc confere
+bool logBodyValid(const uint8_t* block);
+
+// Codifica 'sample' relativo a 'last'; devolve o tamanho
+int  logEncodeRecord(const LogSample& sample, const LogSample& last, uint8_t* record);
+// Decodifica o registro em 'offset' sobre 'sample'. Devolve o
+// tamanho, ou 0 no fim dos registros ou num registro incompleto.
+int  logDecodeRecord(const uint8_t* block, int offset, LogSample& sample);
+
+#endif
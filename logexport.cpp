@@ -0,0 +1,67 @@
+#include "logexport.h"
+
+#include "logstore.h"
+
+#if TELEMETRY_DUMP_DATA != LOG_BLOCK_SIZE
+#error "cada CHUNK leva exatamente um bloco do log"
+#endif
+
+static bool          active     = false;
+static uint16_t      nextOffset = 0;
+static uint16_t      regionSize = 0;
+static unsigned long restoreBaud = 9600;
+
+static void sendPayload(const uint8_t* payload, size_t len) {
+  uint8_t frame[TELEMETRY_FRAME_MAX];
+  Serial.write(frame, telemetryFrame(payload, len, frame));
+}
+
+unsigned long exportStart(const TelemetryDumpRequest& request, unsigned long normalBaud) {
+  uint8_t payload[TELEMETRY_PAYLOAD_MAX];
+
+  TelemetryDumpInfo info;
+  int head     = logHeadBlock();
+  info.tier    = logTier();
+  info.blocks  = (uint8_t)logBlockCount();
+  info.head    = head < 0 ? 0xFF : (uint8_t)head;
+  info.headSeq = logHeadSeq();
+  info.baud    = request.baud > EXPORT_BAUD_MAX_CODE ? EXPORT_BAUD_MAX_CODE : request.baud;
+
+  // Delimitador extra: separa o INFO de uma linha de texto pela metade
+  Serial.write((uint8_t)0x00);
+  sendPayload(payload, telemetryPackDumpInfo(info, payload));
+
+  regionSize  = (uint16_t)(logBlockCount() * LOG_BLOCK_SIZE);
+  nextOffset  = request.offset - request.offset % LOG_BLOCK_SIZE;
+  restoreBaud = normalBaud;
+  active      = true;
+
+  // O INFO sai inteiro na velocidade antiga
+  Serial.flush();
+  Serial.begin(telemetryBaud(info.baud));
+  return EXPORT_SWITCH_MS;
+}
+
+bool exportStep() {
+  if (!active) return false;
+
+  uint8_t payload[TELEMETRY_PAYLOAD_MAX];
+  for (uint8_t i = 0; i < EXPORT_CHUNKS_PER_STEP && nextOffset < regionSize; i++) {
+    TelemetryDumpChunk chunk;
+    chunk.offset = nextOffset;
+    logReadBlock(nextOffset / LOG_BLOCK_SIZE, chunk.data);
+    sendPayload(payload, telemetryPackDumpChunk(chunk, payload));
+    nextOffset += LOG_BLOCK_SIZE;
+  }
+  if (nextOffset < regionSize) return true;
+
+  sendPayload(payload, telemetryPackDumpEnd(regionSize, payload));
+  Serial.flush();
+  Serial.begin(restoreBaud);
+  active = false;
+  return false;
+}
+
+bool exportActive() {
+  return active;
+}
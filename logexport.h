@@ -0,0 +1,34 @@
+/************************************************************
+ *           EXPORTAÇÃO DO LOG EM BLOCOS (SERIAL)           *
+ ************************************************************/
+// Atende um TELEMETRY_DUMP_REQUEST (telemetry.h): manda o INFO na
+// velocidade atual, troca a serial para a velocidade pedida (até
+// EXPORT_BAUD_MAX_CODE) e, EXPORT_SWITCH_MS depois, copia a região
+// do log bloco a bloco, a partir do offset pedido, em quadros CHUNK
+// com CRC. No fim manda END e volta à velocidade normal.
+//
+// A cópia é bruta: os blocos saem como estão na camada (ou na RAM,
+// o bloco aberto) e a ferramenta de host (tools/logdump) remonta e
+// decodifica o anel. Cada exportStep() manda poucos blocos, para não
+// segurar o agendador; enquanto a exportação está ativa, o resto da
+// saída serial fica calado.
+#ifndef LOGEXPORT_H
+#define LOGEXPORT_H
+
+#include <Arduino.h>
+
+#include "telemetry.h"
+
+#define EXPORT_BAUD_MAX_CODE    5     // 500000 baud, erro 0% a 16 MHz
+#define EXPORT_SWITCH_MS        50    // tempo para o host trocar de baud
+#define EXPORT_CHUNKS_PER_STEP  4
+
+// Começa (ou retoma) uma exportação; devolve quantos ms esperar até o
+// primeiro exportStep(). 'normalBaud' é a velocidade a restaurar.
+unsigned long exportStart(const TelemetryDumpRequest& request, unsigned long normalBaud);
+
+// Manda os próximos blocos; devolve false quando a exportação acabou
+bool exportStep();
+bool exportActive();
+
+#endif
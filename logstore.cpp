@@ -0,0 +1,530 @@
+#include "logstore.h"
+
+#include <EEPROM.h>
+
+#include "profile.h"
+
+// Metadados na EEPROM interna: [magic][camada][bloco][seq u16][crc8]
+#define META_MAGIC  0x4C
+#define META_SIZE   6
+
+// Estado do escritor (só em RAM, recuperado por logBegin)
+static uint8_t   tier        = LOG_TIER_INTERNAL;
+static int       blockCount  = LOG_INT_BLOCKS;
+static int       writeBlock  = -1;   // bloco mais novo (-1 = log vazio)
+static int       writeOffset = 0;    // próximo byte livre no bloco
+static uint16_t  writeSeq    = 0;    // sequência do bloco mais novo
+static LogSample last;               // última amostra gravada
+
+// Bloco aberto em RAM; um bit por pedaço de AT24_CHUNK bytes a gravar
+static uint8_t   stage[LOG_BLOCK_SIZE];
+static uint8_t   dirty      = 0;
+static uint32_t  dirtySince = 0;
+
+// Gravação em partes do bloco aberto (logSaveStep)
+#define SAVE_IDLE   0
+#define SAVE_BLOCK  1     // pedaços do bloco, de trás para a frente
+#define SAVE_META   2     // metadados, um byte por passo
+
+static uint8_t   saveState = SAVE_IDLE;
+static uint8_t   saveMask  = 0;      // pedaços desta volta ainda a gravar
+static int8_t    saveChunk = -1;     // pedaço enviado à AT24C32, no ciclo de escrita
+static int       saveNext  = 0;      // próximo byte (EEPROM interna e metadados)
+static uint32_t  saveSince = 0;      // dirtySince do que está sendo gravado
+static uint8_t   saveMeta[META_SIZE];
+static bool      saveFailed = false;
+
+// Amostra que abre o bloco seguinte, esperando o fechado ser gravado
+static bool      openPending = false;
+static LogSample openSample;
+
+/************************************************************
+ *                  CAMADAS E METADADOS                     *
+ ************************************************************/
+// Lê 'len' bytes do bloco gravado na camada atual
+static void loadBlock(int block, uint8_t* out, int len) {
+  if (tier == LOG_TIER_EXTERNAL) {
+    if (!at24Read((uint16_t)(block * LOG_BLOCK_SIZE), out, len)) memset(out, LOG_ERASED, len);
+    return;
+  }
+  int address = LOG_START_ADDRESS + block * LOG_BLOCK_SIZE;
+  for (int i = 0; i < len; i++) out[i] = EEPROM.read(address + i);
+}
+
+// Como loadBlock, mas o bloco aberto vem do buffer de RAM
+static void readBlock(int block, uint8_t* out, int len) {
+  if (block == writeBlock) memcpy(out, stage, len);
+  else                     loadBlock(block, out, len);
+}
+
+static void buildMeta(uint8_t* meta) {
+  meta[0] = META_MAGIC;
+  meta[1] = tier;
+  meta[2] = (uint8_t)writeBlock;
+  meta[3] = (uint8_t)writeSeq;
+  meta[4] = (uint8_t)(writeSeq >> 8);
+  meta[5] = crc8Buffer(meta, META_SIZE - 1);
+}
+
+// De uma vez (boot)
+static void writeMeta() {
+  uint8_t meta[META_SIZE];
+  buildMeta(meta);
+  for (int i = 0; i < META_SIZE; i++) profileEepromUpdate(LOG_META_ADDRESS + i, meta[i]);
+}
+
+static bool loadMeta(int& block, uint16_t& seq) {
+  uint8_t meta[META_SIZE];
+  for (int i = 0; i < META_SIZE; i++) meta[i] = EEPROM.read(LOG_META_ADDRESS + i);
+  if (meta[0] != META_MAGIC || meta[1] != tier || meta[2] >= blockCount ||
+      crc8Buffer(meta, META_SIZE - 1) != meta[META_SIZE - 1]) return false;
+  block = meta[2];
+  seq   = (uint16_t)(meta[3] | (meta[4] << 8));
+  return true;
+}
+
+// Gravação em partes das partes do bloco aberto que mudaram, de trás
+// para a frente, e depois dos metadados. Cada volta pega os pedaços
+// marcados até ali; o que muda durante ela fica para a volta seguinte.
+// Se a AT24C32 não aceita um pedaço (NACK ou tempo esgotado), ele e
+// os que faltam voltam a ficar marcados e os metadados não andam: o
+// próximo logPoll() tenta de novo.
+static bool openBlock(const LogSample& sample);
+
+static void startSave() {
+  if (saveState != SAVE_IDLE || !dirty || writeBlock < 0) return;
+  saveState = SAVE_BLOCK;
+  saveMask  = dirty;
+  saveSince = dirtySince;
+  saveNext  = LOG_BLOCK_SIZE - 1;
+  dirty     = 0;
+}
+
+static void abortSave() {
+  if (saveChunk >= 0) saveMask |= 1 << saveChunk;
+  if (!dirty) dirtySince = saveSince;
+  dirty     |= saveMask;
+  saveMask   = 0;
+  saveChunk  = -1;
+  saveState  = SAVE_IDLE;
+  saveFailed = true;
+}
+
+// Um passo da volta atual do bloco; false quando ela acabou
+static bool saveBlockStep(uint16_t& wait) {
+  if (tier == LOG_TIER_EXTERNAL) {
+    if (saveChunk >= 0) {
+      uint8_t state = at24Poll();
+      if (state == AT24_BUSY) {
+        wait = AT24_POLL_MS;
+        return true;
+      }
+      if (state == AT24_FAILED) {
+        abortSave();
+        wait = LOG_SAVE_IDLE;
+        return true;
+      }
+      saveChunk = -1;
+    }
+    for (int8_t chunk = LOG_BLOCK_SIZE / AT24_CHUNK - 1; chunk >= 0; chunk--) {
+      if (!(saveMask & (1 << chunk))) continue;
+      saveMask &= ~(1 << chunk);
+      saveChunk = chunk;
+      if (!at24WriteChunk((uint16_t)(writeBlock * LOG_BLOCK_SIZE + chunk * AT24_CHUNK),
+                          stage + chunk * AT24_CHUNK, AT24_CHUNK)) {
+        abortSave();
+        wait = LOG_SAVE_IDLE;
+        return true;
+      }
+      wait = AT24_POLL_MS;
+      return true;
+    }
+    return false;
+  }
+
+  // EEPROM interna: um byte que mudou por passo (~3,3 ms)
+  int address = LOG_START_ADDRESS + writeBlock * LOG_BLOCK_SIZE;
+  while (saveNext >= 0) {
+    int i = saveNext--;
+    if (!(saveMask & (1 << (i / AT24_CHUNK)))) continue;
+    if (EEPROM.read(address + i) == stage[i]) continue;
+    profileEepromUpdate(address + i, stage[i]);
+    wait = 0;
+    return true;
+  }
+  saveMask = 0;
+  return false;
+}
+
+uint16_t logSaveStep() {
+  uint16_t wait = 0;
+  if (saveState == SAVE_BLOCK) {
+    if (saveBlockStep(wait)) return wait;
+    if (dirty) {
+      // Mudou durante a volta: outra volta antes dos metadados
+      saveMask  = dirty;
+      saveSince = dirtySince;
+      saveNext  = LOG_BLOCK_SIZE - 1;
+      dirty     = 0;
+      return 0;
+    }
+    saveState = SAVE_META;
+    saveNext  = 0;
+    buildMeta(saveMeta);
+  }
+
+  if (saveState == SAVE_META) {
+    while (saveNext < META_SIZE) {
+      int i = saveNext++;
+      if (EEPROM.read(LOG_META_ADDRESS + i) == saveMeta[i]) continue;
+      profileEepromUpdate(LOG_META_ADDRESS + i, saveMeta[i]);
+      return 0;
+    }
+    saveState = SAVE_IDLE;
+
+    // Bloco fechado gravado: abre o seguinte com a amostra que esperava
+    if (openPending) {
+      openPending = false;
+      openBlock(openSample);
+    }
+  }
+  return LOG_SAVE_IDLE;
+}
+
+bool logSaving() {
+  return saveState != SAVE_IDLE;
+}
+
+// Grava tudo o que está pendente, esperando a AT24C32 (desligamento,
+// boot). Devolve false se a AT24C32 recusou algum pedaço.
+static bool finishSave() {
+  saveFailed = false;
+  while (!saveFailed && (dirty || saveState != SAVE_IDLE)) {
+    startSave();
+    uint16_t wait = logSaveStep();
+    if (wait != LOG_SAVE_IDLE) delay(wait);
+  }
+  return !saveFailed;
+}
+
+static void setStage(int pos, uint8_t value) {
+  if (stage[pos] == value) return;
+  stage[pos] = value;
+  if (!dirty) dirtySince = millis();
+  dirty |= 1 << (pos / AT24_CHUNK);
+}
+
+// Cabeçalho do bloco gravado na camada (sem o buffer de RAM)
+static bool readHeader(int block, uint16_t& seq, LogSample& sample) {
+  uint8_t header[LOG_HEADER_SIZE];
+  loadBlock(block, header, LOG_HEADER_SIZE);
+  return logParseHeader(header, seq, sample);
+}
+
+/************************************************************
+ *                         ESCRITA                          *
+ ************************************************************/
+// Fecha o bloco atual e abre o seguinte com 'sample' como amostra
+// absoluta. O buffer só guarda um bloco: enquanto o fechado não foi
+// gravado, 'sample' espera em openSample e a gravação começa; é o fim
+// dela (logSaveStep) que abre o bloco seguinte.
+static bool openBlock(const LogSample& sample) {
+  if (writeBlock >= 0) {
+    setStage(LOG_BODY_END, crc8Buffer(stage + LOG_HEADER_SIZE, LOG_BODY_END - LOG_HEADER_SIZE));
+    writeOffset = LOG_BODY_END;
+    if (dirty || saveState != SAVE_IDLE) {
+      openPending = true;
+      openSample  = sample;
+      startSave();
+      return true;
+    }
+    writeSeq++;
+  }
+  writeBlock = (writeBlock + 1) % blockCount;
+
+  // O bloco novo substitui inteiro o da volta anterior: gravado de
+  // trás para a frente, o corpo é apagado antes do cabeçalho mudar
+  uint8_t header[LOG_HEADER_SIZE];
+  logBuildHeader(header, writeSeq, sample);
+
+  loadBlock(writeBlock, stage, LOG_BLOCK_SIZE);
+  for (int i = 0; i < LOG_HEADER_SIZE; i++) setStage(i, header[i]);
+  for (int i = LOG_HEADER_SIZE; i < LOG_BLOCK_SIZE; i++) setStage(i, LOG_ERASED);
+
+  writeOffset = LOG_HEADER_SIZE;
+  last        = sample;
+  return true;
+}
+
+// Varredura de todos os blocos: a cabeça é o válido de sequência
+// mais nova. As sequências do anel distam menos de blockCount entre
+// si, então a diferença em int16_t as ordena mesmo após a virada.
+static int scanHead() {
+  uint16_t  seq, newest = 0;
+  LogSample sample;
+  int       head = -1;
+  for (int i = 0; i < blockCount; i++) {
+    if (!readHeader(i, seq, sample)) continue;
+    if (head < 0 || (int16_t)(seq - newest) > 0) {
+      head   = i;
+      newest = seq;
+    }
+  }
+  return head;
+}
+
+static int findHead() {
+  uint16_t  seq, metaSeq;
+  LogSample sample;
+  int       head;
+
+  // ==== PELOS METADADOS ====
+  // Podem estar atrasados se a energia caiu entre a gravação do bloco
+  // e a deles: segue os blocos com as sequências seguintes
+  if (loadMeta(head, metaSeq) && readHeader(head, seq, sample) && seq == metaSeq) {
+    for (int i = 1; i < blockCount; i++) {
+      int next = (head + 1) % blockCount;
+      if (!readHeader(next, seq, sample) || seq != (uint16_t)(metaSeq + i)) break;
+      head = next;
+    }
+    return head;
+  }
+
+  // ==== POR BUSCA BINÁRIA ====
+  // Os blocos 0..k têm sequências consecutivas a partir do bloco 0;
+  // o bloco k é o mais novo. Busca binária pelo último k. Um bloco
+  // corrompido no meio da volta não diz de que lado está a cabeça:
+  // se a sonda cai num, ou no bloco 0, varre todos.
+  if (!readHeader(0, seq, sample)) return scanHead();
+  uint16_t firstSeq = seq;
+  int lo = 0, hi = blockCount - 1;
+  while (lo < hi) {
+    int mid = (lo + hi + 1) / 2;
+    if (!readHeader(mid, seq, sample)) return scanHead();
+    if (seq == (uint16_t)(firstSeq + mid)) lo = mid;
+    else                                   hi = mid - 1;
+  }
+  return lo;
+}
+
+void logBegin() {
+  tier       = at24Begin() ? LOG_TIER_EXTERNAL : LOG_TIER_INTERNAL;
+  blockCount = tier == LOG_TIER_EXTERNAL ? LOG_EXT_BLOCKS : LOG_INT_BLOCKS;
+  writeBlock  = -1;
+  dirty       = 0;
+  saveState   = SAVE_IDLE;
+  saveChunk   = -1;
+  openPending = false;
+
+  int head = findHead();
+  if (head < 0) {
+    writeOffset = 0;
+    writeSeq    = 0;
+    return;
+  }
+
+  // ==== POSIÇÃO DE ESCRITA NO BLOCO MAIS NOVO ====
+  loadBlock(head, stage, LOG_BLOCK_SIZE);
+  logParseHeader(stage, writeSeq, last);
+  writeBlock = head;
+
+  if (stage[LOG_BODY_END] != LOG_ERASED) {
+    writeOffset = LOG_BODY_END;          // bloco já fechado
+    writeMeta();
+    return;
+  }
+
+  int offset = LOG_HEADER_SIZE;
+  while (true) {
+    int len = logDecodeRecord(stage, offset, last);
+    if (len == 0) break;
+    offset += len;
+  }
+
+  // Apaga o que restou de um registro interrompido
+  for (int i = offset; i < LOG_BODY_END; i++) setStage(i, LOG_ERASED);
+  writeOffset = offset;
+  finishSave();
+  writeMeta();
+}
+
+void logAppend(const LogSample& sample) {
+  // Ainda há uma amostra esperando o bloco seguinte abrir: termina a
+  // gravação de uma vez (raro: a gravação leva bem menos que o
+  // intervalo entre amostras). Se a AT24C32 falha, esta se perde.
+  if (openPending && !finishSave()) return;
+
+  // Relógio voltou para trás: recomeça com uma amostra absoluta
+  if (writeBlock < 0 || sample.timestamp / 60 < last.timestamp / 60) {
+    openBlock(sample);
+    return;
+  }
+
+  uint8_t record[LOG_RECORD_MAX];
+  int     len = logEncodeRecord(sample, last, record);
+
+  if (writeOffset + len > LOG_BODY_END) {
+    openBlock(sample);
+    return;
+  }
+
+  for (int i = 0; i < len; i++) setStage(writeOffset + i, record[i]);
+  writeOffset += len;
+
+  // Registros guardam só o minuto; o leitor reconstrói assim
+  last           = sample;
+  last.timestamp = (sample.timestamp / 60) * 60;
+}
+
+void logPoll() {
+  if (dirty && millis() - dirtySince >= LOG_FLUSH_MS) startSave();
+}
+
+void logFlush() {
+  finishSave();
+}
+
+uint8_t logTier() {
+  return tier;
+}
+
+int logBlockCount() {
+  return blockCount;
+}
+
+void logReadBlock(int block, uint8_t* out) {
+  readBlock(block, out, LOG_BLOCK_SIZE);
+}
+
+int logHeadBlock() {
+  return writeBlock;
+}
+
+uint16_t logHeadSeq() {
+  return writeSeq;
+}
+
+/************************************************************
+ *                         LEITURA                          *
+ ************************************************************/
+LogReader::LogReader() : visited(0), offset(0) {}
+
+// Timestamp do cabeçalho na posição lógica 'index' (0 = mais antigo).
+// Falso se o cabeçalho não é válido (bloco nunca usado ou corrompido):
+// aí o tempo do bloco é desconhecido, e não "antes de tudo".
+static bool blockTime(int index, uint32_t& time) {
+  uint8_t   header[LOG_HEADER_SIZE];
+  uint16_t  seq;
+  LogSample sample;
+  readBlock((writeBlock + 1 + index) % blockCount, header, LOG_HEADER_SIZE);
+  if (!logParseHeader(header, seq, sample)) return false;
+  time = sample.timestamp;
+  return true;
+}
+
+void LogReader::seek(uint32_t from) {
+  // Último bloco válido que começa em ou antes de 'from'. Um bloco
+  // ilegível no meio não decide nada: a sonda anda para o vizinho
+  // seguinte até achar um cabeçalho válido dentro do intervalo; se não
+  // há nenhum em [mid, hi], a resposta está abaixo de mid. O leitor
+  // pula sozinho os blocos inválidos que sobrarem no caminho.
+  if (writeBlock < 0) {
+    visited = blockCount;
+    offset  = 0;
+    return;
+  }
+
+  // Antes da primeira volta do anel só os blocos 0..writeBlock foram
+  // gravados (a sequência ainda é o número do bloco), e os de depois,
+  // nunca usados, são os primeiros na ordem lógica: ficam fora da busca
+  // para ela não sondá-los um a um
+  int      first = 0;
+  uint32_t time  = 0;
+  if (writeSeq == (uint16_t)writeBlock && !blockTime(0, time)) first = blockCount - 1 - writeBlock;
+
+  int lo = first, hi = blockCount - 1, found = first;
+  while (lo <= hi) {
+    int mid   = (lo + hi) / 2;
+    int probe = mid;
+    while (probe <= hi && !blockTime(probe, time)) probe++;
+
+    if (probe <= hi && time <= from) {
+      found = probe;
+      lo    = probe + 1;
+    }
+    else {
+      hi = mid - 1;
+    }
+  }
+  visited = found;
+  offset  = 0;
+}
+
+bool LogReader::openBlock() {
+  // Do bloco seguinte ao mais novo (o mais antigo) até o mais novo
+  while (visited < blockCount) {
+    readBlock((writeBlock + 1 + visited++) % blockCount, data, LOG_BLOCK_SIZE);
+
+    uint16_t seq;
+    if (!logParseHeader(data, seq, prev)) continue;
+
+    // Corpo corrompido: só a amostra do cabeçalho é aproveitada
+    offset = logBodyValid(data) ? LOG_HEADER_SIZE : LOG_BODY_END;
+    return true;
+  }
+  return false;
+}
+
+bool LogReader::next(LogSample& out) {
+  while (true) {
+    if (offset == 0) {
+      if (!openBlock()) return false;
+      out = prev;
+      return true;
+    }
+
+    int len = logDecodeRecord(data, offset, prev);
+    if (len == 0) {
+      offset = 0;
+      continue;
+    }
+    offset += len;
+    out     = prev;
+    return true;
+  }
+}
+
+/************************************************************
+ *                        CONSULTAS                         *
+ ************************************************************/
+LogCursor::LogCursor() : returned(0), done(true) {
+  memset(&query, 0, sizeof(query));
+}
+
+LogCursor::LogCursor(const LogQuery& query)
+  : query(query), returned(0), done(false) {
+  reader.seek(query.from);
+}
+
+bool LogCursor::next(LogSample& out) {
+  LogSample sample;
+  while (!done && reader.next(sample)) {
+    if (sample.timestamp < query.from) continue;
+    if (sample.timestamp > query.to) break;
+
+    if (query.changedOnly && returned > 0) {
+      bool changed = ((query.changedOnly & LOG_CH_TEMP) && sample.temp != lastOut.temp) ||
+                     ((query.changedOnly & LOG_CH_HUMD) && sample.humd != lastOut.humd) ||
+                     ((query.changedOnly & LOG_CH_LUM)  && sample.lum  != lastOut.lum);
+      if (!changed) continue;
+    }
+
+    lastOut = sample;
+    returned++;
+    if (query.limit && returned >= query.limit) done = true;
+    out = sample;
+    return true;
+  }
+  done = true;
+  return false;
+}
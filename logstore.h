@@ -0,0 +1,138 @@
+/************************************************************
+ *           LOG DE ANOMALIAS COMPACTO NA EEPROM            *
+ ************************************************************/
+// A região do log é dividida em blocos de LOG_BLOCK_SIZE bytes no
+// formato de logblock.h, gravados em anel.
+//
+// O número de sequência cresce de um em um a cada bloco aberto, e o
+// ponteiro de escrita percorre todos os blocos antes de reutilizar
+// um, o que distribui o desgaste por toda a região.
+//
+// Armazenamento em camadas: o bloco aberto fica num buffer de RAM e
+// só é gravado inteiro (as partes que mudaram), quando fecha ou
+// LOG_FLUSH_MS depois do primeiro registro pendente, em partes
+// espalhadas pelas passadas do agendador (logSaveStep). Os blocos vão
+// para a AT24C32 do módulo do RTC (at24c32.h), onde cada bloco é uma
+// página; sem o chip no barramento, para a EEPROM interna. A EEPROM
+// interna guarda também os metadados quentes (bloco e sequência da
+// cabeça), e no boot a cabeça sai deles sem varrer o I2C; se não
+// conferem, a cabeça é achada por busca binária nas sequências (ou
+// varrendo todos os blocos, se a busca esbarra num corrompido). A
+// leitura vê o buffer de RAM no lugar do bloco aberto.
+//
+// O bloco é gravado de trás para a frente: as flags de um registro
+// vão por último e, se a energia cair no meio, o registro incompleto
+// não é visto e logBegin() limpa o resto.
+#ifndef LOGSTORE_H
+#define LOGSTORE_H
+
+#include <Arduino.h>
+
+#include "at24c32.h"
+#include "logblock.h"
+
+// EEPROM interna: metadados no primeiro bloco, depois os blocos do
+// log quando não há AT24C32 e o arquivo de tendências (archive.h)
+// dessa camada; os episódios (episodes.h) vêm a seguir
+#define LOG_META_ADDRESS   0
+#define LOG_START_ADDRESS  32
+#define LOG_INT_BLOCKS     15     // 480 bytes
+#define LOG_ARCHIVE_INT    (LOG_START_ADDRESS + LOG_INT_BLOCKS * LOG_BLOCK_SIZE)
+#define LOG_ARCHIVE_INT_SIZE  256
+#define LOG_INTERNAL_END   (LOG_ARCHIVE_INT + LOG_ARCHIVE_INT_SIZE)
+
+// AT24C32: os blocos do log e, nas páginas de cima, o arquivo
+#define LOG_EXT_BLOCKS     80     // 2560 bytes
+#define LOG_ARCHIVE_EXT    (LOG_EXT_BLOCKS * LOG_BLOCK_SIZE)
+#define LOG_ARCHIVE_EXT_SIZE  (AT24_SIZE - LOG_ARCHIVE_EXT)   // 1536 bytes
+#define LOG_FLUSH_MS       60000UL   // perda máxima numa queda de energia
+
+// Onde ficam os blocos
+#define LOG_TIER_INTERNAL  0
+#define LOG_TIER_EXTERNAL  1
+
+// Canais (máscaras) para as consultas
+#define LOG_CH_TEMP        0x01
+#define LOG_CH_HUMD        0x02
+#define LOG_CH_LUM         0x04
+#define LOG_CH_ALL         (LOG_CH_TEMP | LOG_CH_HUMD | LOG_CH_LUM)
+
+// Escolhe a camada, localiza a cabeça do anel e recupera o estado
+// do escritor. A Wire já deve estar iniciada.
+void logBegin();
+void logAppend(const LogSample& sample);
+
+// logPoll() (chamada periódica) começa a gravar o bloco aberto se o
+// prazo de LOG_FLUSH_MS venceu; logFlush() grava tudo já, esperando
+// (desligamento).
+void logPoll();
+void logFlush();
+
+// Gravação em partes: enquanto logSaving(), cada logSaveStep() grava
+// um pedaço e devolve quantos ms esperar até o próximo passo, ou
+// LOG_SAVE_IDLE no fim. Na AT24C32 um passo envia um pedaço de
+// AT24_CHUNK bytes ou sonda o fim do ciclo de escrita; na EEPROM
+// interna grava um byte (~3,3 ms). Fechar um bloco também começa a
+// gravação, e a amostra que abre o seguinte espera o fim dela.
+#define LOG_SAVE_IDLE      0xFFFF
+
+bool     logSaving();
+uint16_t logSaveStep();
+
+uint8_t logTier();
+int     logBlockCount();
+
+// Cópia bruta de um bloco físico, com o bloco aberto vindo da RAM
+// (exportação do log); a cabeça é o bloco mais novo, -1 se vazio
+void     logReadBlock(int block, uint8_t* out);
+int      logHeadBlock();
+uint16_t logHeadSeq();
+
+// Leitura sequencial: decodifica o log como um fluxo de amostras,
+// da mais antiga para a mais nova
+class LogReader {
+public:
+  LogReader();
+
+  // Posiciona o leitor no bloco que contém 'from', por busca binária
+  // nos timestamps dos cabeçalhos (o anel está em ordem de tempo);
+  // blocos de cabeçalho inválido são contornados pelo vizinho.
+  void seek(uint32_t from);
+  bool next(LogSample& out);
+
+private:
+  bool openBlock();
+
+  int       visited;      // blocos já visitados, do mais antigo ao mais novo
+  int       offset;       // posição dentro do bloco atual (0 = fora de bloco)
+  LogSample prev;
+  uint8_t   data[LOG_BLOCK_SIZE];   // bloco atual, lido de uma vez
+};
+
+// Consulta por janela de tempo [from, to]. 'changedOnly' não projeta
+// colunas: cada amostra sai inteira. Com ele diferente de 0 (máscara
+// LOG_CH_*), a primeira amostra da janela sai e, depois dela, só as
+// amostras em que algum desses canais mudou em relação à última
+// entregue; as demais são puladas. 'limit' = 0 não limita.
+struct LogQuery {
+  uint32_t from;
+  uint32_t to;
+  uint8_t  changedOnly;
+  uint16_t limit;
+};
+
+class LogCursor {
+public:
+  LogCursor();                       // vazio (para atribuir depois)
+  LogCursor(const LogQuery& query);
+  bool next(LogSample& out);
+
+private:
+  LogReader reader;
+  LogQuery  query;
+  LogSample lastOut;
+  uint16_t  returned;
+  bool      done;
+};
+
+#endif
@@ -0,0 +1,135 @@
+#include "menu.h"
+
+#include "assets.h"
+
+static LcdFrame*       screen   = NULL;
+static const MenuItem* items    = NULL;
+static uint8_t         selected = MENU_NONE;
+static uint8_t         view     = MENU_NONE;
+
+// Cópia em RAM de um item da tabela
+static void load(uint8_t index, MenuItem& out) {
+  out = assetRead(&items[index]);
+}
+
+static uint8_t parentOf(uint8_t index) {
+  return pgm_read_byte(&items[index].parent);
+}
+
+
+void menuBegin(LcdFrame& lcd, const MenuItem* table) {
+  screen   = &lcd;
+  items    = table;
+  selected = pgm_read_byte(&table[0].firstChild);
+  view     = MENU_NONE;
+}
+
+/************************************************************
+ *                        DESENHO                           *
+ ************************************************************/
+static void showList() {
+  MenuItem parent;
+  load(parentOf(selected), parent);
+  uint8_t position = selected - parent.firstChild;
+  uint8_t top      = position == 0 ? 0 : position - 1;
+  if (top + MENU_ROWS > parent.childCount) {
+    top = parent.childCount > MENU_ROWS ? parent.childCount - MENU_ROWS : 0;
+  }
+
+  screen->clear();
+  for (uint8_t row = 0; row < MENU_ROWS && top + row < parent.childCount; row++) {
+    uint8_t index = parent.firstChild + top + row;
+    screen->setCursor(0, row);
+    screen->write(index == selected ? '>' : ' ');
+    screen->print(flashText((PGM_P)pgm_read_ptr(&items[index].label)));
+  }
+}
+
+void menuShow() {
+  if (view == MENU_NONE) {
+    showList();
+    return;
+  }
+  MenuItem item;
+  load(view, item);
+  screen->clear();
+  item.run(item.arg);
+}
+
+void menuRefresh() {
+  if (view == MENU_NONE) return;
+  MenuItem item;
+  load(view, item);
+  item.refresh(item.arg);
+}
+
+/************************************************************
+ *                      NAVEGAÇÃO                           *
+ ************************************************************/
+static void select(const MenuItem& item) {
+  if (item.childCount > 0) {
+    selected = item.firstChild;
+    showList();
+  }
+  else if (item.refresh) {
+    view = selected;
+    screen->clear();
+    item.run(item.arg);
+  }
+  else if (item.run) {
+    // O comando desenha a própria resposta; a lista volta a ser a
+    // do pai, e é redesenhada por quem chamar menuShow()
+    screen->clear();
+    if (parentOf(selected) != 0) selected = parentOf(selected);
+    item.run(item.arg);
+  }
+}
+
+void menuKey(uint8_t key) {
+  // Numa tela aberta, só BACK faz algo
+  if (view != MENU_NONE) {
+    if (key != MENU_KEY_BACK) return;
+    view = MENU_NONE;
+    showList();
+    return;
+  }
+
+  MenuItem item;
+  load(selected, item);
+  uint8_t parent = item.parent;
+  uint8_t first  = pgm_read_byte(&items[parent].firstChild);
+  uint8_t last   = first + pgm_read_byte(&items[parent].childCount) - 1;
+
+  switch (key) {
+    case MENU_KEY_UP:
+      if (selected > first) selected--;
+      showList();
+      break;
+    case MENU_KEY_DOWN:
+      if (selected < last) selected++;
+      showList();
+      break;
+    case MENU_KEY_SELECT:
+      select(item);
+      break;
+    case MENU_KEY_BACK:
+      if (parent == 0) return;
+      selected = parent;
+      showList();
+      break;
+  }
+}
+
+void menuTop() {
+  view = MENU_NONE;
+  while (parentOf(selected) != 0) selected = parentOf(selected);
+  showList();
+}
+
+uint8_t menuSelected() {
+  return selected;
+}
+
+uint8_t menuView() {
+  return view;
+}
@@ -0,0 +1,61 @@
+/************************************************************
+ *              MENU EM TABELA (NA FLASH) + NAVEGADOR        *
+ ************************************************************/
+// A árvore do menu é uma tabela constante de MenuItem em PROGMEM:
+// o item 0 é a raiz, e os filhos de cada item ficam em sequência
+// (firstChild .. firstChild + childCount - 1). Subir e descer é
+// somar ou subtrair 1 dentro dessa faixa, então cada tecla custa
+// tempo constante, e uma tela nova custa só uma linha da tabela.
+//
+// O que SELECT faz depende do item:
+//   - com filhos: entra na lista deles;
+//   - com 'refresh': abre uma tela, desenhada por 'run' e
+//     redesenhada por menuRefresh(); BACK volta à lista;
+//   - só com 'run': executa o comando e volta para a lista do pai.
+//
+// A lista mostra MENU_ROWS itens, com '>' no selecionado: o anterior
+// a ele em cima (ou ele mesmo, se for o primeiro) e o seguinte em
+// baixo, como a tela de 2 linhas sempre mostrou.
+#ifndef MENU_H
+#define MENU_H
+
+#include <Arduino.h>
+
+#include "lcdframe.h"
+
+#define MENU_NONE  0xFF
+#define MENU_ROWS  LCD_FRAME_ROWS
+
+// Teclas do navegador
+#define MENU_KEY_UP      0
+#define MENU_KEY_DOWN    1
+#define MENU_KEY_SELECT  2
+#define MENU_KEY_BACK    3
+
+typedef void (*MenuFn)(uint8_t arg);
+
+struct MenuItem {
+  const char* label;        // texto em PROGMEM
+  MenuFn      run;          // comando ou desenho da tela
+  MenuFn      refresh;      // redesenho periódico (só telas)
+  uint8_t     arg;
+  uint8_t     parent;
+  uint8_t     firstChild;
+  uint8_t     childCount;
+};
+
+// 'table' está em PROGMEM; a seleção começa no primeiro filho da raiz
+void    menuBegin(LcdFrame& lcd, const MenuItem* table);
+
+void    menuKey(uint8_t key);
+// Redesenha a lista (ou a tela aberta)
+void    menuShow();
+// Redesenho periódico da tela aberta; sem tela, não faz nada
+void    menuRefresh();
+// Fecha a tela e sobe até a lista principal
+void    menuTop();
+
+uint8_t menuSelected();
+uint8_t menuView();         // item da tela aberta, ou MENU_NONE
+
+#endif
@@ -0,0 +1,81 @@
+#include "power.h"
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+
+static uint32_t beginMs     = 0;
+static uint32_t sleptMs     = 0;
+static uint16_t sleptRestUs = 0;    // sobra em us, abaixo de 1 ms
+static uint16_t bites       = 0;
+
+// Pedido para sair do sono (escrito pelas ISRs)
+static volatile bool wakeRequest = false;
+
+static void watchdogArm() {
+  // Interrupção e depois reset; o hardware limpa WDIE a cada estouro
+  cli();
+  wdt_reset();
+  wdt_enable(POWER_WDT_TIMEOUT);
+  WDTCSR |= _BV(WDIE);
+  sei();
+}
+
+void powerBegin() {
+  // O SPI não é usado
+  PRR |= _BV(PRSPI);
+
+  watchdogArm();
+  beginMs     = millis();
+  sleptMs     = 0;
+  sleptRestUs = 0;
+}
+
+void powerKick() {
+  wdt_reset();
+  // Depois de uma interrupção do watchdog, volta ao modo interrupção
+  if (!(WDTCSR & _BV(WDIE))) watchdogArm();
+}
+
+void powerIdle(unsigned long ms) {
+  if (ms == 0) return;
+
+  uint32_t startMs = millis();
+  uint32_t startUs = micros();
+  wakeRequest = false;
+
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  while (millis() - startMs < ms && !wakeRequest) {
+    sleep_enable();
+    sleep_cpu();
+    sleep_disable();
+  }
+
+  uint32_t slept = micros() - startUs + sleptRestUs;
+  sleptMs    += slept / 1000;
+  sleptRestUs = slept % 1000;
+}
+
+uint16_t powerDutyPermille() {
+  uint32_t total = millis() - beginMs;
+  if (total == 0) return 1000;
+  return (uint16_t)((uint64_t)(total - sleptMs) * 1000 / total);
+}
+
+uint32_t powerSleptMs() {
+  return sleptMs;
+}
+
+uint16_t powerWatchdogBites() {
+  return bites;
+}
+
+void powerWake() {
+  wakeRequest = true;
+}
+
+ISR(WDT_vect) {
+  bites++;
+  wakeRequest = true;
+}
@@ -0,0 +1,50 @@
+/************************************************************
+ *              ECONOMIA DE ENERGIA ENTRE TAREFAS           *
+ ************************************************************/
+// Quando nenhuma tarefa do agendador está vencida, powerIdle() põe a
+// CPU em SLEEP_MODE_IDLE até a próxima liberação. O clock da CPU
+// para, mas os timers, o ADC e a UART seguem, então o millis(), a
+// amostragem do LDR (Timer1) e a transmissão serial continuam
+// funcionando. Acordam a CPU:
+//
+//   - o estouro do Timer0 (a cada ~1 ms), que mantém o millis();
+//   - a ISR do ADC e as bordas do DHT11 e do SQW do DS3231;
+//   - as bordas dos botões (buttons.h), que encerram o sono na hora
+//     chamando powerWake();
+//   - o watchdog.
+//
+// O power-down não é usado porque pararia o Timer0 e o Timer1, de
+// que dependem o agendador e a amostragem.
+//
+// O watchdog fica no modo interrupção + reset com período de 1 s. O
+// loop o reinicia a cada passada; se uma passada travar, a primeira
+// interrupção acorda a CPU e conta o evento, e a segunda reinicia o
+// MCU.
+//
+// powerDutyPermille() mede a fração do tempo com a CPU acordada
+// desde powerBegin().
+#ifndef POWER_H
+#define POWER_H
+
+#include <Arduino.h>
+#include <avr/wdt.h>
+
+#define POWER_WDT_TIMEOUT  WDTO_1S
+
+// Liga o watchdog e desliga o SPI
+void     powerBegin();
+
+// Dorme até 'ms' milissegundos, ou menos se alguém chamar powerWake()
+void     powerIdle(unsigned long ms);
+
+// Encerra o sono atual; pode ser chamada de uma ISR
+void     powerWake();
+
+// Reinicia o watchdog; chamado uma vez por passada do loop
+void     powerKick();
+
+uint16_t powerDutyPermille();   // tempo acordado, em milésimos
+uint32_t powerSleptMs();
+uint16_t powerWatchdogBites();  // interrupções do watchdog (passadas travadas)
+
+#endif
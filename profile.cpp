@@ -0,0 +1,71 @@
+#include "profile.h"
+
+#if PROFILE_ENABLED
+
+static ProfileStage  stages[PROF_STAGES];
+static uint32_t      counters[PROF_COUNTERS];
+static unsigned long lastStart[2];      // só as etapas de jitter
+
+static const char stageNames[PROF_STAGES][12] PROGMEM = {
+  "passada", "lcd", "display", "dht", "relogio", "registro", "serial",
+  "jit.serial", "jit.display"
+};
+
+static uint8_t bucketFor(uint32_t us) {
+  uint8_t  bucket = 0;
+  uint32_t limit  = PROFILE_FIRST_US;
+  while (bucket < PROFILE_BUCKETS - 1 && us >= limit) {
+    bucket++;
+    limit <<= 1;
+  }
+  return bucket;
+}
+
+void profileRecord(uint8_t stage, uint32_t us) {
+  ProfileStage& s      = stages[stage];
+  uint8_t       bucket = bucketFor(us);
+  if (s.buckets[bucket] == 0xFFFF) {
+    for (uint8_t b = 0; b < PROFILE_BUCKETS; b++) s.buckets[b] >>= 1;
+  }
+  s.buckets[bucket]++;
+  s.count++;
+  if (us > s.maxUs) s.maxUs = us;
+}
+
+void profilePeriod(uint8_t stage, uint32_t periodUs) {
+  unsigned long  now  = micros();
+  unsigned long& last = lastStart[stage - PROF_JITTER_SERIAL];
+  if (last != 0) {
+    uint32_t interval = now - last;
+    profileRecord(stage, interval > periodUs ? interval - periodUs : periodUs - interval);
+  }
+  last = now;
+}
+
+void profileCount(uint8_t counter, uint16_t n) {
+  counters[counter] += n;
+}
+
+void profileReset() {
+  memset(stages, 0, sizeof(stages));
+  memset(counters, 0, sizeof(counters));
+  memset(lastStart, 0, sizeof(lastStart));
+}
+
+const ProfileStage& profileStage(uint8_t stage) {
+  return stages[stage];
+}
+
+uint32_t profileCounter(uint8_t counter) {
+  return counters[counter];
+}
+
+PGM_P profileStageName(uint8_t stage) {
+  return stageNames[stage];
+}
+
+uint32_t profileBucketLimit(uint8_t bucket) {
+  return PROFILE_FIRST_US << bucket;
+}
+
+#endif
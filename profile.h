@@ -0,0 +1,103 @@
+/************************************************************
+ *          PERFIL DE EXECUÇÃO (HISTOGRAMAS E CONTADORES)    *
+ ************************************************************/
+// Instrumentação leve para ver onde o tempo do loop() vai:
+//
+//   - duração de cada etapa (PROF_*) num histograma de faixas em
+//     potência de 2: a faixa 0 conta durações abaixo de
+//     PROFILE_FIRST_US, a faixa i as de [FIRST << (i-1), FIRST << i),
+//     e a última tudo o que passou disso; mais o pior caso;
+//   - jitter de período das tarefas de 1 s (serial e display): o
+//     desvio entre duas execuções seguidas e o período nominal, no
+//     mesmo histograma;
+//   - contadores de transações I2C, bytes gravados na EEPROM interna
+//     e ciclos de escrita da AT24C32.
+//
+// Com PROFILE_ENABLED 0 os macros somem e o módulo não ocupa RAM
+// nem flash; as contagens de I2C do LCD são estimadas pela
+// biblioteca real (PROFILE_LCD_I2C_PER_BYTE transações por byte).
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <Arduino.h>
+#include <EEPROM.h>
+
+#ifndef PROFILE_ENABLED
+#define PROFILE_ENABLED  1
+#endif
+
+// Etapas medidas
+#define PROF_PASS            0    // passada do agendador
+#define PROF_LCD             1    // lcd.flush()
+#define PROF_DISPLAY         2    // desenho da tela (taskDisplay)
+#define PROF_DHT             3    // decodificação do DHT11
+#define PROF_CLOCK           4    // ressincronização com o DS3231
+#define PROF_RECORD          5    // episódios, log e arquivo
+#define PROF_SERIAL          6    // log serial
+#define PROF_JITTER_SERIAL   7
+#define PROF_JITTER_DISPLAY  8
+#define PROF_STAGES          9
+
+// Contadores
+#define PROF_COUNT_I2C       0    // transações I2C
+#define PROF_COUNT_EEPROM    1    // bytes gravados na EEPROM interna
+#define PROF_COUNT_AT24      2    // ciclos de escrita da AT24C32
+#define PROF_COUNTERS        3
+
+#define PROFILE_BUCKETS          12
+#define PROFILE_FIRST_US         16UL   // última faixa: >= 16 ms
+#define PROFILE_LCD_I2C_PER_BYTE 6      // 2 nibbles x (dado, EN alto, EN baixo)
+
+#if PROFILE_ENABLED
+
+// Quando uma faixa enche, todas as da etapa caem pela metade: o
+// histograma guarda a forma da distribuição, e 'count' o total
+struct ProfileStage {
+  uint16_t buckets[PROFILE_BUCKETS];
+  uint32_t count;
+  uint32_t maxUs;
+};
+
+void profileRecord(uint8_t stage, uint32_t us);
+// Registra o desvio entre esta chamada e a anterior da etapa
+void profilePeriod(uint8_t stage, uint32_t periodUs);
+void profileCount(uint8_t counter, uint16_t n = 1);
+void profileReset();
+
+const ProfileStage& profileStage(uint8_t stage);
+uint32_t            profileCounter(uint8_t counter);
+PGM_P               profileStageName(uint8_t stage);      // em PROGMEM
+uint32_t            profileBucketLimit(uint8_t bucket);   // limite superior (us)
+
+// Mede o escopo em que foi declarado
+class ProfileScope {
+public:
+  explicit ProfileScope(uint8_t stage) : stage(stage), start(micros()) {}
+  ~ProfileScope() { profileRecord(stage, micros() - start); }
+
+private:
+  uint8_t       stage;
+  unsigned long start;
+};
+
+#define PROFILE_SCOPE(stage)           ProfileScope profileScope_(stage)
+#define PROFILE_PERIOD(stage, ms)      profilePeriod(stage, (uint32_t)(ms) * 1000UL)
+#define PROFILE_COUNT(counter, n)      profileCount(counter, n)
+
+#else
+
+#define PROFILE_SCOPE(stage)
+#define PROFILE_PERIOD(stage, ms)
+#define PROFILE_COUNT(counter, n)
+
+#endif
+
+// EEPROM.update() que conta os bytes que de fato mudaram
+inline void profileEepromUpdate(int address, uint8_t value) {
+#if PROFILE_ENABLED
+  if (EEPROM.read(address) != value) profileCount(PROF_COUNT_EEPROM);
+#endif
+  EEPROM.update(address, value);
+}
+
+#endif
@@ -0,0 +1,55 @@
+/************************************************************
+ *        FILA CIRCULAR SEM TRAVA (1 PRODUTOR/1 CONSUMIDOR) *
+ ************************************************************/
+// Um lado escreve (normalmente uma ISR) e o outro lê (o loop). Cada
+// índice só é alterado por um dos lados e é de um byte, lido e
+// escrito de forma atômica no AVR, então não é preciso desligar
+// interrupções. Os índices correm livres e SIZE deve ser potência de
+// 2 (no máximo 128): a posição é o índice mascarado.
+#ifndef RING_H
+#define RING_H
+
+#include <Arduino.h>
+
+// Impede o compilador de mover o acesso ao item para depois do índice
+#define RING_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+template <typename T, uint8_t SIZE>
+class SpscRing {
+public:
+  SpscRing() : head(0), tail(0), overruns(0) {}
+
+  // Lado produtor. Com a fila cheia, descarta o item e conta.
+  bool push(const T& item) {
+    uint8_t h = head;
+    if ((uint8_t)(h - tail) >= SIZE) {
+      overruns++;
+      return false;
+    }
+    items[h & (SIZE - 1)] = item;
+    RING_BARRIER();
+    head = h + 1;          // publica só depois de gravar o item
+    return true;
+  }
+
+  // Lado consumidor
+  bool pop(T& item) {
+    uint8_t t = tail;
+    if (t == head) return false;
+    item = items[t & (SIZE - 1)];
+    RING_BARRIER();
+    tail = t + 1;          // libera a posição só depois de copiar
+    return true;
+  }
+
+  uint8_t count() const    { return (uint8_t)(head - tail); }
+  uint8_t dropped() const  { return overruns; }
+
+private:
+  volatile uint8_t head;
+  volatile uint8_t tail;
+  volatile uint8_t overruns;
+  T items[SIZE];
+};
+
+#endif
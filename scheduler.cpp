@@ -0,0 +1,97 @@
+#include "scheduler.h"
+
+Scheduler scheduler;
+
+Scheduler::Scheduler() : taskCount(0), worstPassUs(0), passCount(0) {}
+
+int Scheduler::addPeriodic(PGM_P name, TaskFn fn, unsigned long periodMs,
+                           unsigned long deadlineMs, unsigned long offsetMs) {
+  if (taskCount >= MAX_TASKS) return -1;
+
+  Task& t    = tasks[taskCount];
+  t.name     = name;
+  t.fn       = fn;
+  t.period   = periodMs;
+  t.deadline = deadlineMs;
+  t.nextRun  = millis() + offsetMs;
+  t.active   = true;
+  t.runs     = 0;
+  t.missed   = 0;
+  t.lateRuns = 0;
+  t.totalUs  = 0;
+  t.maxUs    = 0;
+  return taskCount++;
+}
+
+int Scheduler::addTimer(PGM_P name, TaskFn fn) {
+  int id = addPeriodic(name, fn, 0, 0);
+  if (id >= 0) tasks[id].active = false;
+  return id;
+}
+
+void Scheduler::startTimer(int id, unsigned long delayMs) {
+  if (id < 0 || id >= taskCount) return;
+  tasks[id].nextRun = millis() + delayMs;
+  tasks[id].active  = true;
+}
+
+void Scheduler::cancel(int id) {
+  if (id < 0 || id >= taskCount) return;
+  tasks[id].active = false;
+}
+
+void Scheduler::run() {
+  unsigned long passStart = micros();
+
+  for (int i = 0; i < taskCount; i++) {
+    Task& t = tasks[i];
+    if (!t.active) continue;
+
+    unsigned long nowMs = millis();
+    // Comparação por diferença: continua correta no estouro do millis()
+    long lateness = (long)(nowMs - t.nextRun);
+    if (lateness < 0) continue;
+
+    if (t.period == 0) {
+      t.active = false;
+    }
+    else {
+      // Taxa fixa: a próxima liberação não acumula o atraso desta.
+      t.nextRun += t.period;
+      if ((unsigned long)lateness >= t.period) {
+        // Perdeu períodos inteiros: conta e ressincroniza
+        t.missed += lateness / t.period;
+        t.nextRun = nowMs + t.period;
+      }
+    }
+    if (t.deadline > 0 && (unsigned long)lateness > t.deadline) {
+      t.lateRuns++;
+    }
+
+    unsigned long start = micros();
+    t.fn();
+    unsigned long elapsed = micros() - start;
+
+    t.runs++;
+    t.totalUs += elapsed;
+    if (elapsed > t.maxUs) t.maxUs = elapsed;
+  }
+
+  unsigned long passUs = micros() - passStart;
+  if (passUs > worstPassUs) worstPassUs = passUs;
+  passCount++;
+}
+
+unsigned long Scheduler::msUntilNextRun() const {
+  unsigned long nowMs = millis();
+  unsigned long best  = 0xFFFFFFFFUL;
+
+  for (int i = 0; i < taskCount; i++) {
+    const Task& t = tasks[i];
+    if (!t.active) continue;
+    long wait = (long)(t.nextRun - nowMs);
+    if (wait <= 0) return 0;
+    if ((unsigned long)wait < best) best = wait;
+  }
+  return best;
+}
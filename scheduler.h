@@ -0,0 +1,70 @@
+/************************************************************
+ *           AGENDADOR COOPERATIVO DE TAREFAS               *
+ ************************************************************/
+// Tarefas periódicas (com prazo) e temporizadores one-shot,
+// executados a partir do loop() sem delay() nem espera ativa.
+// Cada tarefa deve ser curta: o agendador não preempta.
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+// O firmware registra 14 tarefas e temporizadores; a folga evita que
+// a próxima tarefa fique sem posição (o setup() para se isso ocorrer)
+#define MAX_TASKS 16
+
+typedef void (*TaskFn)();
+
+struct Task {
+  PGM_P         name;       // em PROGMEM (PSTR)
+  TaskFn        fn;
+  unsigned long period;     // ms entre execuções (0 = one-shot)
+  unsigned long deadline;   // atraso máximo tolerado após a liberação (ms)
+  unsigned long nextRun;    // instante (millis) da próxima liberação
+  bool          active;
+
+  // Contabilidade de execução
+  unsigned long runs;       // quantas vezes executou
+  unsigned long missed;     // períodos pulados por atraso
+  unsigned long lateRuns;   // execuções que começaram após o prazo
+  unsigned long totalUs;    // tempo total de CPU (us)
+  unsigned long maxUs;      // pior tempo de uma execução (us)
+};
+
+class Scheduler {
+public:
+  Scheduler();
+
+  // Registra uma tarefa periódica. offsetMs desloca a primeira
+  // liberação para espalhar tarefas de mesmo período. O nome fica
+  // na flash: addPeriodic(PSTR("sample"), ...).
+  int addPeriodic(PGM_P name, TaskFn fn, unsigned long periodMs,
+                  unsigned long deadlineMs, unsigned long offsetMs = 0);
+
+  // Registra um temporizador one-shot (inativo até startTimer).
+  int addTimer(PGM_P name, TaskFn fn);
+
+  void startTimer(int id, unsigned long delayMs);
+  void cancel(int id);
+
+  // Uma passada: executa, em ordem de registro, toda tarefa vencida.
+  void run();
+
+  // Tempo até a próxima liberação (0 se alguma já venceu).
+  unsigned long msUntilNextRun() const;
+
+  const Task&   task(int id) const { return tasks[id]; }
+  int           count() const      { return taskCount; }
+  unsigned long maxPassUs() const  { return worstPassUs; }
+  unsigned long passes() const     { return passCount; }
+
+private:
+  Task          tasks[MAX_TASKS];
+  int           taskCount;
+  unsigned long worstPassUs;
+  unsigned long passCount;
+};
+
+extern Scheduler scheduler;
+
+#endif
@@ -0,0 +1,156 @@
+#include "shell.h"
+
+static Print*              output   = NULL;
+static const ShellCommand* commands = NULL;
+static uint8_t             commandCount = 0;
+
+static char      line[SHELL_LINE_SIZE];
+static uint8_t   length   = 0;
+static bool      overflow = false;
+static bool      ready    = false;   // linha completa esperando execução
+static ShellStep job      = NULL;
+static uint8_t   helpIndex = 0;
+
+// INT32_MAX: o stdint.h do avr-libc só o define em C++ com
+// __STDC_LIMIT_MACROS
+#define FIXED_MAX 2147483647L
+
+void shellBegin(Print& out, const ShellCommand* table, uint8_t count) {
+  output       = &out;
+  commands     = table;
+  commandCount = count;
+  length       = 0;
+  overflow     = false;
+  ready        = false;
+  job          = NULL;
+}
+
+/************************************************************
+ *                   MONTAGEM DA LINHA                      *
+ ************************************************************/
+void shellFeed(uint8_t byte) {
+  if (ready) return;                  // a anterior ainda não rodou
+
+  if (byte == '\r' || byte == '\n') {
+    if (overflow) {
+      output->println(F("linha longa demais"));
+    }
+    else if (length > 0) {
+      line[length] = '\0';
+      ready = true;
+    }
+    length   = 0;
+    overflow = false;
+    return;
+  }
+  if (byte == 0x08 || byte == 0x7F) {  // backspace
+    if (length > 0) length--;
+    return;
+  }
+  if (byte < ' ') return;
+
+  if (length < SHELL_LINE_SIZE - 1) line[length++] = (char)byte;
+  else                              overflow = true;
+}
+
+void shellDiscard() {
+  length   = 0;
+  overflow = false;
+}
+
+/************************************************************
+ *                        EXECUÇÃO                          *
+ ************************************************************/
+static void execute() {
+  // Palavras separadas por espaço, no próprio buffer
+  char*   argv[SHELL_MAX_ARGS];
+  uint8_t argc = 0;
+  char*   p    = line;
+  while (*p && argc < SHELL_MAX_ARGS) {
+    while (*p == ' ' || *p == '\t') *p++ = '\0';
+    if (!*p) break;
+    argv[argc++] = p;
+    while (*p && *p != ' ' && *p != '\t') p++;
+  }
+  if (argc == 0) return;
+
+  size_t nameLength = strlen(argv[0]);
+  for (uint8_t i = 0; i < commandCount && nameLength < SHELL_USAGE_SIZE; i++) {
+    // O nome é a primeira palavra do texto de uso
+    PGM_P usage = commands[i].usage;
+    char  after = (char)pgm_read_byte(usage + nameLength);
+    if (strncmp_P(argv[0], usage, nameLength) != 0 || (after != ' ' && after != '\0')) continue;
+
+    ShellHandler run = (ShellHandler)pgm_read_ptr(&commands[i].run);
+    if (!run(argc, argv)) {
+      output->print(F("uso: "));
+      output->println(flashText(usage));
+    }
+    return;
+  }
+  output->print(F("comando desconhecido: "));
+  output->print(argv[0]);
+  output->println(F(" (ajuda)"));
+}
+
+void shellPoll() {
+  for (uint8_t steps = 0; steps < SHELL_STEPS_PER_POLL; steps++) {
+    if (!job && !ready) return;
+    // A resposta de um comando também é uma linha
+    if (output->availableForWrite() < SHELL_OUTPUT_ROOM) return;
+    if (job) {
+      if (!job()) job = NULL;
+      continue;
+    }
+    execute();
+    ready = false;
+  }
+}
+
+bool shellBusy() {
+  return job != NULL;
+}
+
+void shellStartJob(ShellStep step) {
+  job = step;
+}
+
+static bool helpStep() {
+  if (helpIndex >= commandCount) return false;
+  output->print(F("  "));
+  output->println(flashText(commands[helpIndex++].usage));
+  return true;
+}
+
+void shellHelp() {
+  output->println(F("Comandos:"));
+  helpIndex = 0;
+  shellStartJob(helpStep);
+}
+
+bool shellParseFixed(const char* text, uint8_t decimals, int32_t& out) {
+  bool    negative = *text == '-';
+  int32_t value    = 0;
+  int8_t  places   = -1;              // casas lidas depois do ponto
+  if (negative) text++;
+  if (!*text) return false;
+
+  for (; *text; text++) {
+    if ((*text == '.' || *text == ',') && places < 0) {
+      places = 0;
+      continue;
+    }
+    if (*text < '0' || *text > '9' || places >= (int8_t)decimals) return false;
+    int8_t digit = *text - '0';
+    if (value > FIXED_MAX / 10 || value * 10 > FIXED_MAX - digit) return false;   // cabe em int32_t
+    value = value * 10 + digit;
+    if (places >= 0) places++;
+  }
+  // As casas que faltam também multiplicam: "99999999" com 2 casas não cabe
+  for (int8_t i = places < 0 ? 0 : places; i < (int8_t)decimals; i++) {
+    if (value > FIXED_MAX / 10) return false;
+    value *= 10;
+  }
+  out = negative ? -value : value;
+  return true;
+}
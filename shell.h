@@ -0,0 +1,66 @@
+/************************************************************
+ *            INTERPRETADOR DE COMANDOS (SERIAL)            *
+ ************************************************************/
+// Linhas de texto terminadas em '\r' ou '\n', montadas byte a byte
+// num buffer fixo de SHELL_LINE_SIZE (sem String) e quebradas em
+// palavras no próprio buffer. A primeira palavra escolhe o comando
+// na tabela passada a shellBegin(), que fica na flash (PROGMEM) com
+// o texto de uso de cada comando; o nome é a primeira palavra desse
+// texto. As demais palavras viram argc/argv.
+// Linhas longas demais são descartadas inteiras.
+//
+// Nenhum comando imprime muito de uma vez: quem tem uma lista para
+// mostrar registra um passo com shellStartJob(), e shellPoll() chama
+// esse passo uma linha por vez, só enquanto o buffer de transmissão
+// da serial tem espaço (SHELL_OUTPUT_ROOM) e no máximo
+// SHELL_STEPS_PER_POLL vezes por chamada. Cada passo (e a resposta
+// direta de um comando) imprime no máximo SHELL_OUTPUT_ROOM bytes,
+// então o loop nunca fica preso esperando a UART. Enquanto um
+// comando lista, a próxima linha já digitada espera pronta; o que
+// chegar depois dela é ignorado.
+#ifndef SHELL_H
+#define SHELL_H
+
+#include <Arduino.h>
+
+#include "assets.h"
+
+#define SHELL_LINE_SIZE       48
+#define SHELL_MAX_ARGS        6
+#define SHELL_OUTPUT_ROOM     60    // bytes livres na TX para mais uma linha (AVR: até 63)
+#define SHELL_STEPS_PER_POLL  4
+#define SHELL_USAGE_SIZE      40
+
+// Devolve false se os argumentos não servem (imprime o uso)
+typedef bool (*ShellHandler)(uint8_t argc, char** argv);
+// Imprime a próxima linha; devolve false quando acabou
+typedef bool (*ShellStep)();
+
+struct ShellCommand {
+  char         usage[SHELL_USAGE_SIZE];   // "nome [argumentos]"
+  ShellHandler run;
+};
+
+// 'commands' está em PROGMEM
+void shellBegin(Print& out, const ShellCommand* commands, uint8_t count);
+
+// Um byte de texto recebido
+void shellFeed(uint8_t byte);
+// Descarta a linha em curso (por exemplo, quando começa um quadro)
+void shellDiscard();
+
+// Executa a linha pronta e avança o comando em curso; chamada
+// periódica, de custo limitado
+void shellPoll();
+bool shellBusy();
+void shellStartJob(ShellStep step);
+
+// Lista de comandos com o uso de cada um
+void shellHelp();
+
+// Número inteiro ou com até 'decimals' casas ("-12", "21.5"),
+// devolvido multiplicado por 10^decimals; false se o resultado não
+// cabe em int32_t
+bool shellParseFixed(const char* text, uint8_t decimals, int32_t& out);
+
+#endif
@@ -0,0 +1,173 @@
+/************************************************************
+ *        ESTATÍSTICAS POR CANAL EM JANELA DE TEMPO         *
+ ************************************************************/
+// Cada canal (temperatura, umidade, luminosidade) mantém somas
+// correntes de uma janela deslizante de 'windowMs' milissegundos,
+// dividida em BUCKETS fatias de tempo iguais. Uma amostra nova
+// entra na fatia atual; quando o tempo passa de uma fatia, a mais
+// antiga sai das somas da janela. Assim média e variância custam
+// O(1) por amostra e não dependem de quantas amostras couberam na
+// janela nem da velocidade do loop.
+//
+// Mínimo e máximo são mantidos por fatia e recalculados só na troca
+// de fatia (BUCKETS comparações). A EMA é independente da janela e
+// acompanha todas as amostras com peso 1/2^EMA_SHIFT.
+//
+// O tipo das somas vem de StatsTraits<T>: float para float, e
+// acumuladores mais largos para inteiros. A janela guarda no máximo
+// STATS_MAX_SAMPLES amostras, o que mantém as somas de int16_t em
+// 32 bits; com a janela cheia, uma amostra a mais é ignorada por
+// inteiro (média, variância, mínimo e máximo) e só a EMA a vê. A
+// média de inteiros é arredondada ao mais próximo.
+//
+// tools/statscheck confere a janela contra uma conta direta sobre
+// as amostras guardadas.
+#ifndef STATS_H
+#define STATS_H
+
+#include <Arduino.h>
+
+#define STATS_MAX_SAMPLES  0xFFFF
+
+template <typename T> struct StatsTraits;
+
+template <> struct StatsTraits<float> {
+  typedef float Sum;
+  typedef float SumSq;
+  static float divide(float sum, uint16_t n) { return sum / n; }
+};
+
+template <> struct StatsTraits<int16_t> {
+  typedef int32_t Sum;
+  typedef int64_t SumSq;
+  // Metade arredondada para longe do zero, como o arquivo (archive.cpp)
+  static int32_t divide(int32_t sum, uint16_t n) {
+    return sum >= 0 ? (sum + n / 2) / n : -((-sum + n / 2) / n);
+  }
+};
+
+template <typename T, uint8_t BUCKETS = 5, uint8_t EMA_SHIFT = 3>
+class ChannelStats {
+public:
+  typedef typename StatsTraits<T>::Sum   Sum;
+  typedef typename StatsTraits<T>::SumSq SumSq;
+
+  ChannelStats(uint32_t windowMs)
+    : bucketMs(windowMs / BUCKETS ? windowMs / BUCKETS : 1) {
+    reset();
+  }
+
+  void reset() {
+    for (uint8_t i = 0; i < BUCKETS; i++) clearBucket(i);
+    head = 0; bucketStart = 0; started = false;
+    total = 0; totalSum = 0; totalSumSq = 0;
+    lo = 0; hi = 0; emaState = 0;
+  }
+
+  void add(T value, uint32_t nowMs) {
+    advance(nowMs);
+
+    if (!started) {
+      bucketStart = nowMs;
+      emaState    = (Sum)value * (1 << EMA_SHIFT);
+      started     = true;
+    }
+    else {
+      emaState += (Sum)value - emaState / (1 << EMA_SHIFT);
+    }
+
+    if (total >= STATS_MAX_SAMPLES) return;
+
+    Bucket& b = buckets[head];
+    if (b.count == 0 || value < b.lo) b.lo = value;
+    if (b.count == 0 || value > b.hi) b.hi = value;
+    b.count++;
+    b.sum   += value;
+    b.sumSq += (SumSq)value * value;
+    total++;
+    totalSum   += value;
+    totalSumSq += (SumSq)value * value;
+
+    if (total == 1 || value < lo) lo = value;
+    if (total == 1 || value > hi) hi = value;
+  }
+
+  // Descarta as fatias que saíram da janela até 'nowMs'
+  void advance(uint32_t nowMs) {
+    if (!started) return;
+    uint32_t elapsed = nowMs - bucketStart;
+    if (elapsed < bucketMs) return;
+
+    uint32_t steps = elapsed / bucketMs;
+    bucketStart += steps * bucketMs;
+    if (steps > BUCKETS) steps = BUCKETS;
+
+    while (steps--) {
+      head = (head + 1) % BUCKETS;
+      total      -= buckets[head].count;
+      totalSum   -= buckets[head].sum;
+      totalSumSq -= buckets[head].sumSq;
+      clearBucket(head);
+    }
+    recomputeRange();
+  }
+
+  uint16_t count() const { return total; }
+  T        min() const   { return lo; }
+  T        max() const   { return hi; }
+  T        ema() const   { return (T)(emaState / (1 << EMA_SHIFT)); }
+
+  T mean() const {
+    if (total == 0) return 0;
+    return (T)StatsTraits<T>::divide(totalSum, total);
+  }
+
+  // Variância populacional da janela (unidades ao quadrado)
+  Sum variance() const {
+    if (total < 2) return 0;
+    SumSq n = total;
+    return (Sum)((n * totalSumSq - (SumSq)totalSum * totalSum) / (n * n));
+  }
+
+private:
+  struct Bucket {
+    uint16_t count;
+    T        lo;
+    T        hi;
+    Sum      sum;
+    SumSq    sumSq;
+  };
+
+  void clearBucket(uint8_t i) {
+    buckets[i].count = 0;
+    buckets[i].lo    = 0;
+    buckets[i].hi    = 0;
+    buckets[i].sum   = 0;
+    buckets[i].sumSq = 0;
+  }
+
+  void recomputeRange() {
+    bool any = false;
+    for (uint8_t i = 0; i < BUCKETS; i++) {
+      if (buckets[i].count == 0) continue;
+      if (!any || buckets[i].lo < lo) lo = buckets[i].lo;
+      if (!any || buckets[i].hi > hi) hi = buckets[i].hi;
+      any = true;
+    }
+    if (!any) { lo = 0; hi = 0; }
+  }
+
+  Bucket   buckets[BUCKETS];
+  uint32_t bucketMs;
+  uint32_t bucketStart;   // início da fatia atual
+  uint8_t  head;          // fatia atual
+  bool     started;
+  uint16_t total;
+  Sum      totalSum;
+  SumSq    totalSumSq;
+  T        lo;
+  T        hi;
+  Sum      emaState;      // EMA × 2^EMA_SHIFT
+};
+
+#endif
@@ -0,0 +1,262 @@
+#include "telemetry.h"
+
+/************************************************************
+ *                       CRC E COBS                         *
+ ************************************************************/
+uint16_t crc16(uint16_t crc, const uint8_t* data, size_t len) {
+  while (len--) {
+    crc ^= (uint16_t)(*data++) << 8;
+    for (int i = 0; i < 8; i++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out) {
+  size_t  write    = 1;
+  size_t  codeAt   = 0;
+  uint8_t code     = 1;
+
+  for (size_t read = 0; read < len; read++) {
+    if (in[read] == 0) {
+      out[codeAt] = code;
+      code        = 1;
+      codeAt      = write++;
+    }
+    else {
+      out[write++] = in[read];
+      if (++code == 0xFF) {
+        out[codeAt] = code;
+        code        = 1;
+        codeAt      = write++;
+      }
+    }
+  }
+  out[codeAt] = code;
+  return write;
+}
+
+size_t cobsDecode(const uint8_t* in, size_t len, uint8_t* out) {
+  size_t read  = 0;
+  size_t write = 0;
+
+  while (read < len) {
+    uint8_t code = in[read++];
+    if (code == 0) return 0;
+    for (uint8_t i = 1; i < code; i++) {
+      if (read >= len || in[read] == 0) return 0;
+      out[write++] = in[read++];
+    }
+    if (code < 0xFF && read < len) out[write++] = 0;
+  }
+  return write;
+}
+
+/************************************************************
+ *                      SERIALIZAÇÃO                        *
+ ************************************************************/
+static uint8_t* put16(uint8_t* out, uint16_t value) {
+  *out++ = (uint8_t)value;
+  *out++ = (uint8_t)(value >> 8);
+  return out;
+}
+
+static uint8_t* put32(uint8_t* out, uint32_t value) {
+  out = put16(out, (uint16_t)value);
+  return put16(out, (uint16_t)(value >> 16));
+}
+
+static uint16_t get16(const uint8_t* in) {
+  return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint32_t get32(const uint8_t* in) {
+  return get16(in) | ((uint32_t)get16(in + 2) << 16);
+}
+
+size_t telemetryPackSample(const TelemetrySample& sample, uint8_t* out) {
+  uint8_t* p = out;
+  *p++ = TELEMETRY_SAMPLE;
+  *p++ = sample.seq;
+  p = put32(p, sample.timestamp);
+  p = put16(p, (uint16_t)sample.temp);
+  p = put16(p, (uint16_t)sample.tempAvg);
+  p = put16(p, (uint16_t)sample.humd);
+  p = put16(p, (uint16_t)sample.humdAvg);
+  *p++ = (uint8_t)sample.lum;
+  p = put16(p, sample.ldrRaw);
+  *p++ = sample.flags;
+  return p - out;
+}
+
+size_t telemetryPackRecord(const TelemetryRecord& record, uint8_t* out) {
+  uint8_t* p = out;
+  *p++ = TELEMETRY_RECORD;
+  p = put32(p, record.timestamp);
+  p = put16(p, (uint16_t)record.temp);
+  p = put16(p, (uint16_t)record.humd);
+  *p++ = (uint8_t)record.lum;
+  return p - out;
+}
+
+size_t telemetryPackEpisode(const TelemetryEpisode& episode, uint8_t* out) {
+  uint8_t* p = out;
+  *p++ = TELEMETRY_EPISODE;
+  *p++ = episode.event;
+  *p++ = episode.channel;
+  p = put32(p, episode.start);
+  p = put16(p, episode.minutes);
+  p = put16(p, (uint16_t)episode.min);
+  p = put16(p, (uint16_t)episode.max);
+  p = put16(p, (uint16_t)episode.mean);
+  return p - out;
+}
+
+bool telemetryUnpackSample(const uint8_t* in, size_t len, TelemetrySample& sample) {
+  if (len != TELEMETRY_SAMPLE_SIZE || in[0] != TELEMETRY_SAMPLE) return false;
+  sample.seq       = in[1];
+  sample.timestamp = get32(in + 2);
+  sample.temp      = (int16_t)get16(in + 6);
+  sample.tempAvg   = (int16_t)get16(in + 8);
+  sample.humd      = (int16_t)get16(in + 10);
+  sample.humdAvg   = (int16_t)get16(in + 12);
+  sample.lum       = (int8_t)in[14];
+  sample.ldrRaw    = get16(in + 15);
+  sample.flags     = in[17];
+  return true;
+}
+
+bool telemetryUnpackRecord(const uint8_t* in, size_t len, TelemetryRecord& record) {
+  if (len != TELEMETRY_RECORD_SIZE || in[0] != TELEMETRY_RECORD) return false;
+  record.timestamp = get32(in + 1);
+  record.temp      = (int16_t)get16(in + 5);
+  record.humd      = (int16_t)get16(in + 7);
+  record.lum       = (int8_t)in[9];
+  return true;
+}
+
+bool telemetryUnpackEpisode(const uint8_t* in, size_t len, TelemetryEpisode& episode) {
+  if (len != TELEMETRY_EPISODE_SIZE || in[0] != TELEMETRY_EPISODE) return false;
+  episode.event   = in[1];
+  episode.channel = in[2];
+  episode.start   = get32(in + 3);
+  episode.minutes = get16(in + 7);
+  episode.min     = (int16_t)get16(in + 9);
+  episode.max     = (int16_t)get16(in + 11);
+  episode.mean    = (int16_t)get16(in + 13);
+  return true;
+}
+
+/************************************************************
+ *                   EXPORTAÇÃO DO LOG                      *
+ ************************************************************/
+uint32_t telemetryBaud(uint8_t code) {
+  static const uint32_t bauds[TELEMETRY_BAUD_CODES] = {
+    9600, 38400, 57600, 115200, 250000, 500000, 1000000
+  };
+  return bauds[code < TELEMETRY_BAUD_CODES ? code : 0];
+}
+
+size_t telemetryPackDumpRequest(const TelemetryDumpRequest& request, uint8_t* out) {
+  uint8_t* p = out;
+  *p++ = TELEMETRY_DUMP_REQUEST;
+  p = put16(p, request.offset);
+  *p++ = request.baud;
+  return p - out;
+}
+
+size_t telemetryPackDumpInfo(const TelemetryDumpInfo& info, uint8_t* out) {
+  uint8_t* p = out;
+  *p++ = TELEMETRY_DUMP_INFO;
+  *p++ = info.tier;
+  *p++ = info.blocks;
+  *p++ = info.head;
+  p = put16(p, info.headSeq);
+  *p++ = info.baud;
+  return p - out;
+}
+
+size_t telemetryPackDumpChunk(const TelemetryDumpChunk& chunk, uint8_t* out) {
+  uint8_t* p = out;
+  *p++ = TELEMETRY_DUMP_CHUNK;
+  p = put16(p, chunk.offset);
+  for (int i = 0; i < TELEMETRY_DUMP_DATA; i++) *p++ = chunk.data[i];
+  return p - out;
+}
+
+size_t telemetryPackDumpEnd(uint16_t size, uint8_t* out) {
+  uint8_t* p = out;
+  *p++ = TELEMETRY_DUMP_END;
+  p = put16(p, size);
+  return p - out;
+}
+
+bool telemetryUnpackDumpRequest(const uint8_t* in, size_t len, TelemetryDumpRequest& request) {
+  if (len != TELEMETRY_DUMP_REQUEST_SIZE || in[0] != TELEMETRY_DUMP_REQUEST) return false;
+  request.offset = get16(in + 1);
+  request.baud   = in[3];
+  return true;
+}
+
+bool telemetryUnpackDumpInfo(const uint8_t* in, size_t len, TelemetryDumpInfo& info) {
+  if (len != TELEMETRY_DUMP_INFO_SIZE || in[0] != TELEMETRY_DUMP_INFO) return false;
+  info.tier    = in[1];
+  info.blocks  = in[2];
+  info.head    = in[3];
+  info.headSeq = get16(in + 4);
+  info.baud    = in[6];
+  return true;
+}
+
+bool telemetryUnpackDumpChunk(const uint8_t* in, size_t len, TelemetryDumpChunk& chunk) {
+  if (len != TELEMETRY_DUMP_CHUNK_SIZE || in[0] != TELEMETRY_DUMP_CHUNK) return false;
+  chunk.offset = get16(in + 1);
+  for (int i = 0; i < TELEMETRY_DUMP_DATA; i++) chunk.data[i] = in[3 + i];
+  return true;
+}
+
+bool telemetryUnpackDumpEnd(const uint8_t* in, size_t len, uint16_t& size) {
+  if (len != TELEMETRY_DUMP_END_SIZE || in[0] != TELEMETRY_DUMP_END) return false;
+  size = get16(in + 1);
+  return true;
+}
+
+/************************************************************
+ *                       QUADROS                            *
+ ************************************************************/
+size_t telemetryFrame(const uint8_t* payload, size_t len, uint8_t* out) {
+  uint8_t  raw[TELEMETRY_PAYLOAD_MAX + 2];
+  uint16_t crc = crc16(0xFFFF, payload, len);
+
+  for (size_t i = 0; i < len; i++) raw[i] = payload[i];
+  put16(raw + len, crc);
+
+  size_t n = cobsEncode(raw, len + 2, out);
+  out[n++] = 0x00;
+  return n;
+}
+
+TelemetryReceiver::TelemetryReceiver() : length(0), overflow(false), badCount(0) {}
+
+size_t TelemetryReceiver::feed(uint8_t byte) {
+  if (byte != 0x00) {
+    if (length < sizeof(buffer)) buffer[length++] = byte;
+    else                         overflow = true;
+    return 0;
+  }
+
+  size_t n   = length;
+  bool   bad = overflow;
+  length   = 0;
+  overflow = false;
+  if (n == 0) return 0;
+
+  // O COBS decodificado nunca passa à frente da leitura
+  if (!bad) n = cobsDecode(buffer, n, buffer);
+  if (bad || n < 3 || crc16(0xFFFF, buffer, n - 2) != (uint16_t)(buffer[n - 2] | (buffer[n - 1] << 8))) {
+    badCount++;
+    return 0;
+  }
+  return n - 2;
+}
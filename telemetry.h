@@ -0,0 +1,156 @@
+/************************************************************
+ *          TELEMETRIA BINÁRIA (QUADROS COBS + CRC)         *
+ ************************************************************/
+// Alternativa compacta ao log em texto da serial. Cada quadro é:
+//
+//   COBS( [tipo][payload][crc16] ) 0x00
+//
+// O CRC é o CRC-16/CCITT-FALSE de tipo + payload, em little-endian.
+// O COBS elimina os zeros do quadro, então 0x00 só aparece como
+// delimitador e o receptor se ressincroniza no próximo zero.
+// Todos os campos são little-endian. Este módulo não depende da
+// HAL: é compilado também pelo decodificador de host (tools/).
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define TELEMETRY_SAMPLE   0x01   // amostra periódica
+#define TELEMETRY_RECORD   0x02   // anomalia gravada na EEPROM
+#define TELEMETRY_EPISODE  0x03   // início/atualização/fim de um episódio
+
+// Exportação do log (host -> aparelho: só o pedido)
+#define TELEMETRY_DUMP_REQUEST  0x10   // início ou retomada
+#define TELEMETRY_DUMP_INFO     0x11   // camada, anel e baud escolhido
+#define TELEMETRY_DUMP_CHUNK    0x12   // um bloco bruto do log
+#define TELEMETRY_DUMP_END      0x13
+
+#define TELEMETRY_SAMPLE_SIZE  18
+#define TELEMETRY_RECORD_SIZE  10
+#define TELEMETRY_EPISODE_SIZE 15
+#define TELEMETRY_DUMP_REQUEST_SIZE 4
+#define TELEMETRY_DUMP_INFO_SIZE    7
+#define TELEMETRY_DUMP_DATA         32     // um bloco do log por quadro
+#define TELEMETRY_DUMP_CHUNK_SIZE   (3 + TELEMETRY_DUMP_DATA)
+#define TELEMETRY_DUMP_END_SIZE     3
+#define TELEMETRY_PAYLOAD_MAX  36
+// tipo/payload + crc, mais o byte de código COBS e o delimitador
+#define TELEMETRY_FRAME_MAX    (TELEMETRY_PAYLOAD_MAX + 2 + 2)
+
+// Flags de alerta da amostra
+#define TELEMETRY_ALERT_TEMP   0x01
+#define TELEMETRY_ALERT_HUMD   0x02
+#define TELEMETRY_ALERT_LIGHT  0x04
+#define TELEMETRY_BUZZER       0x08
+#define TELEMETRY_SCALE_SHIFT  4      // bits 4-5: escala (1=C, 2=F, 3=K)
+
+// Temperatura em centésimos de °C e umidade em centésimos de %. A
+// escala nas flags é só a preferência de exibição do aparelho.
+struct TelemetrySample {
+  uint8_t  seq;          // contador de amostras (detecta perdas)
+  uint32_t timestamp;
+  int16_t  temp;
+  int16_t  tempAvg;
+  int16_t  humd;
+  int16_t  humdAvg;
+  int8_t   lum;          // %
+  uint16_t ldrRaw;       // 12 bits, sobreamostrado
+  uint8_t  flags;
+};
+
+struct TelemetryRecord {
+  uint32_t timestamp;
+  int16_t  temp;
+  int16_t  humd;
+  int8_t   lum;
+};
+
+// Episódio de anomalia de um canal (episodes.h). min/max/média na
+// unidade do canal: centésimos para temperatura e umidade, % para a
+// luminosidade.
+struct TelemetryEpisode {
+  uint8_t  event;        // 1 = início, 2 = atualização, 3 = fim
+  uint8_t  channel;      // 0 = temp, 1 = umid, 2 = luz
+  uint32_t start;
+  uint16_t minutes;
+  int16_t  min;
+  int16_t  max;
+  int16_t  mean;
+};
+
+// Exportação do log: o host pede a partir de 'offset' (bytes da
+// região do log, múltiplo de TELEMETRY_DUMP_DATA) e a maior
+// velocidade que aceita. O aparelho responde com INFO na velocidade
+// atual, troca para o baud escolhido, manda os blocos como CHUNKs
+// (cada um protegido pelo CRC do quadro), END e volta à velocidade
+// normal. Um link que caiu é retomado com um novo pedido a partir
+// do primeiro bloco que faltou.
+struct TelemetryDumpRequest {
+  uint16_t offset;
+  uint8_t  baud;         // código, ver telemetryBaud()
+};
+
+struct TelemetryDumpInfo {
+  uint8_t  tier;         // LOG_TIER_* (logstore.h)
+  uint8_t  blocks;       // blocos do anel
+  uint8_t  head;         // bloco mais novo (0xFF = log vazio)
+  uint16_t headSeq;      // sequência do bloco mais novo
+  uint8_t  baud;
+};
+
+struct TelemetryDumpChunk {
+  uint16_t offset;
+  uint8_t  data[TELEMETRY_DUMP_DATA];
+};
+
+// Velocidades da exportação, em ordem crescente
+#define TELEMETRY_BAUD_CODES  7
+uint32_t telemetryBaud(uint8_t code);
+
+uint16_t crc16(uint16_t crc, const uint8_t* data, size_t len);
+
+size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out);
+// Devolve o tamanho decodificado, ou 0 se o quadro for inválido
+size_t cobsDecode(const uint8_t* in, size_t len, uint8_t* out);
+
+// Serializa o tipo + payload (sem CRC/COBS); devolve o tamanho
+size_t telemetryPackSample(const TelemetrySample& sample, uint8_t* out);
+size_t telemetryPackRecord(const TelemetryRecord& record, uint8_t* out);
+size_t telemetryPackEpisode(const TelemetryEpisode& episode, uint8_t* out);
+bool   telemetryUnpackSample(const uint8_t* in, size_t len, TelemetrySample& sample);
+bool   telemetryUnpackRecord(const uint8_t* in, size_t len, TelemetryRecord& record);
+bool   telemetryUnpackEpisode(const uint8_t* in, size_t len, TelemetryEpisode& episode);
+
+size_t telemetryPackDumpRequest(const TelemetryDumpRequest& request, uint8_t* out);
+size_t telemetryPackDumpInfo(const TelemetryDumpInfo& info, uint8_t* out);
+size_t telemetryPackDumpChunk(const TelemetryDumpChunk& chunk, uint8_t* out);
+size_t telemetryPackDumpEnd(uint16_t size, uint8_t* out);
+bool   telemetryUnpackDumpRequest(const uint8_t* in, size_t len, TelemetryDumpRequest& request);
+bool   telemetryUnpackDumpInfo(const uint8_t* in, size_t len, TelemetryDumpInfo& info);
+bool   telemetryUnpackDumpChunk(const uint8_t* in, size_t len, TelemetryDumpChunk& chunk);
+bool   telemetryUnpackDumpEnd(const uint8_t* in, size_t len, uint16_t& size);
+
+// Acrescenta CRC, aplica COBS e o delimitador; devolve o tamanho do quadro
+size_t telemetryFrame(const uint8_t* payload, size_t len, uint8_t* out);
+
+// Montagem dos quadros recebidos, byte a byte: feed() devolve o
+// tamanho do tipo + payload (sem o CRC) quando um quadro válido
+// termina no delimitador, e 0 nos demais bytes. Quadros com CRC ou
+// COBS inválido, ou longos demais, são descartados e contados.
+class TelemetryReceiver {
+public:
+  TelemetryReceiver();
+
+  size_t         feed(uint8_t byte);
+  const uint8_t* payload() const   { return buffer; }
+  unsigned long  badFrames() const { return badCount; }
+
+private:
+  uint8_t       buffer[TELEMETRY_FRAME_MAX];   // decodificado no lugar
+  size_t        length;
+  bool          overflow;
+  unsigned long badCount;
+};
+
+#endif
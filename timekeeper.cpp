@@ -0,0 +1,139 @@
+#include "timekeeper.h"
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#include "profile.h"
+
+static RTC_DS3231* clockRtc  = NULL;
+static int32_t     offsetSec = 0;
+static uint8_t     sqwMask   = 0;
+
+// Hora local, campo a campo
+static uint16_t year;
+static uint8_t  month, day, hour, minute, second;
+static uint32_t unixLocal;
+
+static uint32_t lastTickMs  = 0;   // millis() da última borda aplicada
+static uint32_t tickCount   = 0;
+static uint16_t resyncCount = 0;
+static uint16_t fixCount    = 0;
+
+// Bordas ainda não aplicadas (escrito pela ISR)
+static volatile uint8_t pendingTicks = 0;
+static uint8_t          lastPins     = 0xFF;
+
+static uint8_t daysInMonth(uint8_t m, uint16_t y) {
+  static const uint8_t days[12] PROGMEM = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+  if (m == 2 && (y % 4) == 0 && ((y % 100) != 0 || (y % 400) == 0)) return 29;
+  return pgm_read_byte(&days[m - 1]);
+}
+
+static void setLocal(uint32_t t) {
+  DateTime dt(t);
+  year      = dt.year();
+  month     = dt.month();
+  day       = dt.day();
+  hour      = dt.hour();
+  minute    = dt.minute();
+  second    = dt.second();
+  unixLocal = t;
+}
+
+// Avança um segundo, propagando o "vai um" só quando precisa
+static void tick() {
+  unixLocal++;
+  if (++second < 60) return;
+  second = 0;
+  if (++minute < 60) return;
+  minute = 0;
+  if (++hour < 24) return;
+  hour = 0;
+  if (++day <= daysInMonth(month, year)) return;
+  day = 1;
+  if (++month <= 12) return;
+  month = 1;
+  year++;
+}
+
+// Aplica as bordas acumuladas pela ISR (ou, sem SQW, o millis())
+static void catchUp() {
+  uint8_t  ticks = pendingTicks;
+  uint32_t nowMs = millis();
+
+  if (ticks) {
+    // Só a ISR incrementa: subtrair o que foi lido não perde bordas
+    cli();
+    pendingTicks -= ticks;
+    sei();
+    lastTickMs = nowMs;
+    tickCount += ticks;
+  }
+  else if (nowMs - lastTickMs >= CLOCK_SQW_TIMEOUT_MS) {
+    ticks       = (uint8_t)((nowMs - lastTickMs) / 1000);
+    lastTickMs += (uint32_t)ticks * 1000;
+  }
+
+  while (ticks--) tick();
+}
+
+void clockBegin(RTC_DS3231& rtc, uint8_t sqwPin, int8_t utcOffsetHours) {
+  clockRtc  = &rtc;
+  offsetSec = (int32_t)utcOffsetHours * 3600;
+  sqwMask   = _BV(sqwPin & 0x07);
+
+  // SQW é dreno aberto: precisa do pull-up
+  pinMode(sqwPin, INPUT_PULLUP);
+  rtc.writeSqwPinMode(DS3231_SquareWave1Hz);
+
+  cli();
+  lastPins = PIND;
+  PCMSK2  |= sqwMask;
+  PCICR   |= _BV(PCIE2);
+  sei();
+
+  resyncCount = 0;
+  fixCount    = 0;
+  clockResync();
+}
+
+void clockResync() {
+  if (!clockRtc) return;
+
+  catchUp();
+  PROFILE_COUNT(PROF_COUNT_I2C, 2);       // ponteiro + 7 registradores
+  uint32_t t = clockRtc->now().unixtime() + offsetSec;
+
+  // Uma borda durante a leitura já está no segundo lido
+  cli();
+  uint8_t late = pendingTicks;
+  pendingTicks = 0;
+  sei();
+  lastTickMs = millis();
+  tickCount += late;
+
+  if (resyncCount > 0 && t != unixLocal + late) fixCount++;
+  resyncCount++;
+  setLocal(t);
+}
+
+DateTime clockNow() {
+  catchUp();
+  return DateTime(year, month, day, hour, minute, second);
+}
+
+uint32_t clockUnix() {
+  catchUp();
+  return unixLocal;
+}
+
+uint32_t clockTicks()       { return tickCount; }
+uint16_t clockResyncs()     { return resyncCount; }
+uint16_t clockCorrections() { return fixCount; }
+
+// Borda de descida do SQW = virada de segundo no DS3231
+ISR(PCINT2_vect) {
+  uint8_t pins = PIND;
+  if ((lastPins & sqwMask) && !(pins & sqwMask)) pendingTicks++;
+  lastPins = pins;
+}
@@ -0,0 +1,40 @@
+/************************************************************
+ *       RELÓGIO LOCAL DISCIPLINADO PELO SQW DO DS3231      *
+ ************************************************************/
+// O DS3231 é lido uma vez no boot e depois só a cada
+// CLOCK_RESYNC_MS. Entre essas leituras, a hora local anda pela saída
+// SQW de 1 Hz do próprio RTC. Ela está ligada a um pino com
+// interrupção de mudança de pino, e a ISR só conta as bordas de
+// descida. A data e a hora locais (já com o fuso) são mantidas
+// campo a campo, um segundo por vez, sem divisões nem I2C a cada
+// consulta.
+//
+// Se o SQW parar (fio solto, RTC ausente), o relógio passa a contar
+// pelo millis() até voltar a receber bordas; a ressincronização
+// periódica corrige o que tiver escorregado.
+#ifndef TIMEKEEPER_H
+#define TIMEKEEPER_H
+
+#include <Arduino.h>
+#include <RTClib.h>
+
+#define CLOCK_RESYNC_MS       3600000UL   // relê o DS3231 a cada hora
+#define CLOCK_SQW_TIMEOUT_MS  1500        // sem borda por mais que isso: usa millis()
+
+// Configura o SQW de 1 Hz no pino 'sqwPin' (PORTD, 0..7) e lê a hora
+// inicial. 'utcOffsetHours' converte a hora UTC do RTC para local.
+void     clockBegin(RTC_DS3231& rtc, uint8_t sqwPin, int8_t utcOffsetHours);
+
+// Lê o DS3231 e corrige a hora local
+void     clockResync();
+
+// Hora local atual
+DateTime clockNow();
+uint32_t clockUnix();        // segundos desde 1970, hora local
+
+// Contadores
+uint32_t clockTicks();       // bordas SQW recebidas
+uint16_t clockResyncs();
+uint16_t clockCorrections(); // ressincronizações que mudaram a hora
+
+#endif
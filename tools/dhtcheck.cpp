@@ -0,0 +1,35 @@
+/************************************************************
+ *         CONFERÊNCIA DO DRIVER DO DHT11 (dht11.h)         *
+ ************************************************************/
+//   dhtcheck [leituras]
+// Faz leituras seguidas do sensor simulado no pino 3 (INT1) e exige
+// que todas passem no checksum. A partir da segunda, o sentido de
+// EICRA já é FALLING e o pulso de início deixa o pedido pendente em
+// EIFR; sem limpá-lo antes do attachInterrupt(), a ISR conta uma
+// borda a mais e os 40 bits saem deslocados. Devolve 1 na primeira
+// falha.
+#include <Arduino.h>
+#include <stdio.h>
+
+#include "sim.h"
+#include "../dht11.h"
+
+#define DHT_PIN 3
+
+int main(int argc, char** argv) {
+  unsigned long reads = argc > 1 ? strtoul(argv[1], NULL, 10) : 2;
+
+  simDhtAttach(DHT_PIN);
+  Dht11 dht(DHT_PIN);
+  dht.begin();
+
+  for (unsigned long i = 0; i < reads; i++) {
+    while (!dht.available()) delay(dht.poll());
+    if (dht.status() != DHT11_OK) {
+      printf("leitura %lu: status %u (esperado %u)\n", i + 1, dht.status(), DHT11_OK);
+      return 1;
+    }
+  }
+  printf("%lu leituras seguidas: checksum confere em todas\n", reads);
+  return 0;
+}
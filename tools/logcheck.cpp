@@ -0,0 +1,77 @@
+/************************************************************
+ *        CONFERÊNCIA DA CABEÇA DO ANEL (logstore.h)        *
+ ************************************************************/
+//   logcheck
+// Enche o anel do log além de uma volta nas duas camadas (EEPROM
+// interna e AT24C32), invalida os metadados e corrompe o cabeçalho
+// de um bloco de cada vez, inclusive o do meio, onde cai a primeira
+// sonda da busca binária. A cada logBegin() a cabeça tem de voltar
+// ao mesmo bloco e sequência. Devolve 1 na primeira diferença.
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <Wire.h>
+#include <stdio.h>
+
+#include "sim.h"
+#include "../logstore.h"
+
+// Um byte do cabeçalho gravado do bloco, na camada atual
+static uint8_t peek(int block) {
+  uint16_t address = (uint16_t)(block * LOG_BLOCK_SIZE + 1);
+  if (logTier() == LOG_TIER_INTERNAL) return EEPROM.read(LOG_START_ADDRESS + address);
+  uint8_t value = 0;
+  at24Read(address, &value, 1);
+  return value;
+}
+
+static void poke(int block, uint8_t value) {
+  uint16_t address = (uint16_t)(block * LOG_BLOCK_SIZE + 1);
+  if (logTier() == LOG_TIER_INTERNAL) EEPROM.write(LOG_START_ADDRESS + address, value);
+  else                                at24Write(address, &value, 1);
+}
+
+static bool check(bool external) {
+  simAt24Attach(external);
+  for (int i = 0; i < LOG_INTERNAL_END; i++) EEPROM.write(i, 0xFF);
+  logBegin();
+
+  // Uma volta e três quartos: a cabeça fica depois do meio do anel
+  int       blocks = logBlockCount();
+  uint16_t  target = (uint16_t)(blocks + blocks * 3 / 4);
+  LogSample sample = { 1000000UL, 200, 500, 30 };
+  while (logHeadSeq() < target) {
+    sample.timestamp += 60;
+    sample.temp = (int16_t)(200 + (sample.timestamp / 60) % 37);
+    logAppend(sample);
+    while (logSaving()) delay(logSaveStep());
+  }
+  logFlush();
+
+  int      head = logHeadBlock();
+  uint16_t seq  = logHeadSeq();
+  EEPROM.write(LOG_META_ADDRESS, 0);      // força a busca nos blocos
+
+  for (int block = 0; block < blocks; block++) {
+    if (block == head) continue;
+    uint8_t original = peek(block);
+    poke(block, original ^ 0xFF);
+    logBegin();
+    poke(block, original);
+    EEPROM.write(LOG_META_ADDRESS, 0);    // logBegin() os regravou
+    if (logHeadBlock() != head || logHeadSeq() != seq) {
+      printf("%s, bloco %d corrompido: cabeça %d seq %u (esperado %d seq %u)\n",
+             external ? "AT24C32" : "EEPROM interna", block, logHeadBlock(),
+             logHeadSeq(), head, seq);
+      return false;
+    }
+  }
+  printf("%s: %d blocos, cabeça %d achada com cada um dos outros corrompido\n",
+         external ? "AT24C32" : "EEPROM interna", blocks, head);
+  return true;
+}
+
+int main() {
+  Wire.begin();
+  if (!check(false) || !check(true)) return 1;
+  return 0;
+}
@@ -0,0 +1,285 @@
+/************************************************************
+ *        EXPORTAÇÃO DO LOG -> CSV (LINHA DE COMANDO)       *
+ ************************************************************/
+//   logdump --port /dev/ttyUSB0 [--baud C] [--offset N] > log.csv
+//   logdump captura.bin [outra.bin ...] > log.csv
+//
+// Ao vivo, pede a exportação (telemetry.h), troca de velocidade
+// depois do INFO e, se o link cair (nenhum byte por DUMP_IDLE_MS
+// antes do END), pede de novo a partir do primeiro bloco que falta,
+// até DUMP_RETRIES vezes. Com capturas (ex.: datalogger-sim --dump-at
+// ... --serial-file), junta os blocos de todas e diz de qual offset
+// retomar se faltar algum. Os blocos são ordenados pela sequência e
+// decodificados com o mesmo código do firmware (logblock.h).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "../telemetry.h"
+#include "../logblock.h"
+
+#define DUMP_MAX_BLOCKS  256
+#define DUMP_RETRIES     8
+#define DUMP_INFO_MS     3000
+#define DUMP_IDLE_MS     1000
+#define DUMP_BAUD        5        // 500000, o máximo do firmware
+
+// Cópia da região do log, montada a partir dos CHUNKs recebidos
+struct DumpImage {
+  TelemetryDumpInfo info;
+  bool              haveInfo;
+  bool              ended;
+  bool              have[DUMP_MAX_BLOCKS];
+  uint8_t           data[DUMP_MAX_BLOCKS * LOG_BLOCK_SIZE];
+  unsigned long     chunks;
+
+  DumpImage() : haveInfo(false), ended(false), chunks(0) {
+    memset(have, 0, sizeof(have));
+  }
+
+  void handle(const uint8_t* payload, size_t len) {
+    TelemetryDumpChunk chunk;
+    uint16_t           size;
+    if (telemetryUnpackDumpInfo(payload, len, info)) {
+      haveInfo = true;
+      ended    = false;
+    }
+    else if (telemetryUnpackDumpChunk(payload, len, chunk)) {
+      int block = chunk.offset / LOG_BLOCK_SIZE;
+      if (block >= DUMP_MAX_BLOCKS) return;
+      memcpy(data + block * LOG_BLOCK_SIZE, chunk.data, LOG_BLOCK_SIZE);
+      have[block] = true;
+      chunks++;
+    }
+    else if (telemetryUnpackDumpEnd(payload, len, size)) {
+      ended = true;
+    }
+  }
+
+  // Offset do primeiro bloco que falta, ou -1 se está completa
+  long firstMissing() const {
+    if (!haveInfo) return 0;
+    for (int b = 0; b < info.blocks; b++) {
+      if (!have[b]) return (long)b * LOG_BLOCK_SIZE;
+    }
+    return -1;
+  }
+};
+
+/************************************************************
+ *                       DECODIFICAÇÃO                      *
+ ************************************************************/
+struct BlockRef {
+  uint16_t age;      // distância até a sequência mais nova
+  int      block;
+};
+
+static bool olderFirst(const BlockRef& a, const BlockRef& b) {
+  return a.age > b.age;
+}
+
+static void formatTime(uint32_t timestamp, char* out, size_t size) {
+  time_t     t = (time_t)timestamp;
+  struct tm  parts;
+  gmtime_r(&t, &parts);            // o firmware já grava a hora local
+  strftime(out, size, "%Y-%m-%d %H:%M:%S", &parts);
+}
+
+static unsigned long writeCsv(const DumpImage& image, FILE* out) {
+  std::vector<BlockRef> blocks;
+  for (int b = 0; b < image.info.blocks; b++) {
+    uint16_t  seq;
+    LogSample sample;
+    if (!image.have[b] || !logParseHeader(image.data + b * LOG_BLOCK_SIZE, seq, sample)) continue;
+    BlockRef ref;
+    ref.age   = (uint16_t)(image.info.headSeq - seq);
+    ref.block = b;
+    blocks.push_back(ref);
+  }
+  std::stable_sort(blocks.begin(), blocks.end(), olderFirst);
+
+  fprintf(out, "timestamp,datetime,temp,humd,lum\n");
+  unsigned long samples = 0;
+  char          when[24];
+  for (size_t i = 0; i < blocks.size(); i++) {
+    const uint8_t* block = image.data + blocks[i].block * LOG_BLOCK_SIZE;
+    uint16_t       seq;
+    LogSample      sample;
+    logParseHeader(block, seq, sample);
+
+    // Corpo corrompido: só a amostra do cabeçalho é aproveitada
+    int offset = logBodyValid(block) ? LOG_HEADER_SIZE : LOG_BODY_END;
+    while (true) {
+      formatTime(sample.timestamp, when, sizeof(when));
+      fprintf(out, "%lu,%s,%.2f,%.2f,%d\n", (unsigned long)sample.timestamp, when,
+              sample.temp / 100.0, sample.humd / 100.0, sample.lum);
+      samples++;
+
+      int len = logDecodeRecord(block, offset, sample);
+      if (len == 0) break;
+      offset += len;
+    }
+  }
+  return samples;
+}
+
+/************************************************************
+ *                        AO VIVO                           *
+ ************************************************************/
+static speed_t speedFor(uint32_t baud) {
+  switch (baud) {
+    case 9600:    return B9600;
+    case 38400:   return B38400;
+    case 57600:   return B57600;
+    case 115200:  return B115200;
+#ifdef B500000
+    case 500000:  return B500000;
+#endif
+#ifdef B1000000
+    case 1000000: return B1000000;
+#endif
+  }
+  return B0;
+}
+
+static bool setSpeed(int fd, uint32_t baud) {
+  speed_t speed = speedFor(baud);
+  struct termios tio;
+  if (speed == B0 || tcgetattr(fd, &tio) != 0) return false;
+  cfmakeraw(&tio);
+  cfsetispeed(&tio, speed);
+  cfsetospeed(&tio, speed);
+  tio.c_cc[VMIN]  = 0;
+  tio.c_cc[VTIME] = 1;          // read() volta após 100 ms sem bytes
+  return tcsetattr(fd, TCSADRAIN, &tio) == 0;
+}
+
+static long nowMs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000L + ts.tv_nsec / 1000000L;
+}
+
+// Lê quadros até 'done' ou até 'idleMs' sem bytes
+static void receive(int fd, TelemetryReceiver& receiver, DumpImage& image,
+                    bool (*done)(const DumpImage&), long idleMs) {
+  long last = nowMs();
+  while (!done(image) && nowMs() - last < idleMs) {
+    uint8_t buffer[256];
+    ssize_t n = read(fd, buffer, sizeof(buffer));
+    if (n <= 0) continue;
+    last = nowMs();
+    for (ssize_t i = 0; i < n; i++) {
+      size_t len = receiver.feed(buffer[i]);
+      if (len > 0) image.handle(receiver.payload(), len);
+    }
+  }
+}
+
+static bool gotInfo(const DumpImage& image) { return image.haveInfo; }
+static bool gotEnd(const DumpImage& image)  { return image.ended; }
+
+static bool dumpLive(const char* port, uint8_t baud, long offset, DumpImage& image) {
+  int fd = open(port, O_RDWR | O_NOCTTY);
+  if (fd < 0 || !setSpeed(fd, telemetryBaud(0))) {
+    perror(port);
+    return false;
+  }
+
+  TelemetryReceiver receiver;
+  for (int attempt = 0; attempt < DUMP_RETRIES && offset >= 0; attempt++) {
+    TelemetryDumpRequest request;
+    request.offset = (uint16_t)offset;
+    request.baud   = baud;
+
+    uint8_t payload[TELEMETRY_PAYLOAD_MAX];
+    uint8_t frame[TELEMETRY_FRAME_MAX + 1];
+    frame[0] = 0x00;              // fecha qualquer lixo no receptor
+    size_t n = telemetryFrame(payload, telemetryPackDumpRequest(request, payload), frame + 1);
+    if (write(fd, frame, n + 1) != (ssize_t)(n + 1)) break;
+    tcdrain(fd);
+
+    image.haveInfo = false;
+    receive(fd, receiver, image, gotInfo, DUMP_INFO_MS);
+    if (!image.haveInfo) {
+      fprintf(stderr, "sem resposta, tentando de novo\n");
+      continue;
+    }
+
+    // O aparelho troca de velocidade logo depois do INFO
+    setSpeed(fd, telemetryBaud(image.info.baud));
+    receive(fd, receiver, image, gotEnd, DUMP_IDLE_MS);
+    setSpeed(fd, telemetryBaud(0));
+
+    offset = image.firstMissing();
+    if (offset >= 0) fprintf(stderr, "link caiu, retomando do offset %ld\n", offset);
+  }
+  close(fd);
+  return image.firstMissing() < 0;
+}
+
+/************************************************************
+ *                          MAIN                            *
+ ************************************************************/
+int main(int argc, char** argv) {
+  const char* port   = NULL;
+  uint8_t     baud   = DUMP_BAUD;
+  long        offset = 0;
+  static DumpImage image;        // ~8 KB, fora da pilha
+  TelemetryReceiver receiver;
+  int         files  = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--port") && i + 1 < argc)        port   = argv[++i];
+    else if (!strcmp(argv[i], "--baud") && i + 1 < argc)   baud   = (uint8_t)atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--offset") && i + 1 < argc) offset = atol(argv[++i]);
+    else if (argv[i][0] != '-') {
+      FILE* in = fopen(argv[i], "rb");
+      if (!in) {
+        perror(argv[i]);
+        return 1;
+      }
+      int c;
+      while ((c = fgetc(in)) != EOF) {
+        size_t len = receiver.feed((uint8_t)c);
+        if (len > 0) image.handle(receiver.payload(), len);
+      }
+      fclose(in);
+      files++;
+    }
+    else {
+      fprintf(stderr, "uso: %s --port DEV [--baud C] [--offset N] > log.csv\n"
+                      "     %s captura.bin [...] > log.csv\n", argv[0], argv[0]);
+      return 2;
+    }
+  }
+
+  if (port) dumpLive(port, baud, offset, image);
+  else if (files == 0) {
+    fprintf(stderr, "nada a ler: use --port ou capturas\n");
+    return 2;
+  }
+
+  if (!image.haveInfo) {
+    fprintf(stderr, "nenhuma exportação encontrada\n");
+    return 1;
+  }
+
+  unsigned long samples = writeCsv(image, stdout);
+  long missing = image.firstMissing();
+  fprintf(stderr, "%s, %u blocos, %lu quadros, %lu inválidos, %lu amostras\n",
+          image.info.tier ? "AT24C32" : "EEPROM interna", image.info.blocks,
+          image.chunks, receiver.badFrames(), samples);
+  if (missing >= 0) {
+    fprintf(stderr, "faltam blocos: retome com --offset %ld\n", missing);
+    return 1;
+  }
+  return 0;
+}
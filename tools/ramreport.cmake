@@ -0,0 +1,123 @@
+# Relatório de RAM estática por módulo do firmware.
+#
+#   cmake --build build --target ram-report
+#
+# Soma, em cada objeto, as seções que o AVR carrega na RAM: .data
+# (inclusive as constantes sem PROGMEM, que o avr-gcc copia da flash
+# no boot), .rodata e .bss. O que está em PROGMEM (.progmem*) conta
+# como flash. Compilado para o host, os ponteiros têm 8 bytes e os
+# int 4, então os números são uma estimativa por cima; com o avr-size
+# (SIZE_TOOL) sobre objetos do AVR, são os do chip.
+#
+# Variáveis: SIZE_TOOL (programa 'size') e OBJECTS (lista de .o).
+
+if(NOT SIZE_TOOL OR NOT OBJECTS)
+  message(FATAL_ERROR "uso: cmake -DSIZE_TOOL=size -DOBJECTS=\"a.o;b.o\" -P ramreport.cmake")
+endif()
+
+# Alinha 'text' à direita em 'width' colunas
+function(pad_left out text width)
+  string(LENGTH "${text}" len)
+  set(result "${text}")
+  while(len LESS width)
+    set(result " ${result}")
+    math(EXPR len "${len} + 1")
+  endwhile()
+  set(${out} "${result}" PARENT_SCOPE)
+endfunction()
+
+function(pad_right out text width)
+  string(LENGTH "${text}" len)
+  set(result "${text}")
+  while(len LESS width)
+    set(result "${result} ")
+    math(EXPR len "${len} + 1")
+  endwhile()
+  set(${out} "${result}" PARENT_SCOPE)
+endfunction()
+
+set(total_data  0)
+set(total_const 0)
+set(total_bss   0)
+set(total_flash 0)
+set(rows "")
+
+foreach(object ${OBJECTS})
+  execute_process(COMMAND ${SIZE_TOOL} -A ${object}
+                  OUTPUT_VARIABLE listing RESULT_VARIABLE failed)
+  if(failed)
+    message(FATAL_ERROR "${SIZE_TOOL} falhou em ${object}")
+  endif()
+
+  set(data  0)
+  set(const 0)
+  set(bss   0)
+  set(flash 0)
+  string(REPLACE "\n" ";" lines "${listing}")
+  foreach(line ${lines})
+    if(NOT line MATCHES "^(\\.[^ ]+) +([0-9]+)")
+      continue()
+    endif()
+    set(section "${CMAKE_MATCH_1}")
+    set(size    "${CMAKE_MATCH_2}")
+    if(section MATCHES "^\\.progmem")
+      math(EXPR flash "${flash} + ${size}")
+    elseif(section MATCHES "^\\.bss")
+      math(EXPR bss "${bss} + ${size}")
+    elseif(section MATCHES "^\\.data")
+      math(EXPR data "${data} + ${size}")
+    elseif(section MATCHES "^\\.rodata")
+      math(EXPR const "${const} + ${size}")
+    endif()
+  endforeach()
+
+  math(EXPR ram "${data} + ${const} + ${bss}")
+  math(EXPR total_data  "${total_data} + ${data}")
+  math(EXPR total_const "${total_const} + ${const}")
+  math(EXPR total_bss   "${total_bss} + ${bss}")
+  math(EXPR total_flash "${total_flash} + ${flash}")
+
+  # codigo-fonte.cpp.o -> codigo-fonte
+  get_filename_component(module ${object} NAME)
+  string(REGEX REPLACE "\\.(cpp|c)\\.(o|obj)$" "" module "${module}")
+  list(APPEND rows "${ram}|${module}|${data}|${const}|${bss}|${flash}")
+endforeach()
+
+# Maiores primeiro: a RAM vai na frente, com zeros à esquerda para
+# a ordenação de texto
+set(sorted "")
+foreach(row ${rows})
+  string(REGEX MATCH "^[0-9]+" ram "${row}")
+  pad_left(key "${ram}" 8)
+  string(REPLACE " " "0" key "${key}")
+  list(APPEND sorted "${key}|${row}")
+endforeach()
+list(SORT sorted)
+list(REVERSE sorted)
+
+message("RAM estática por módulo (bytes)")
+message("módulo              .data  const   .bss    RAM  PROGMEM")
+foreach(row ${sorted})
+  string(REPLACE "|" ";" fields "${row}")
+  list(GET fields 1 ram)
+  list(GET fields 2 module)
+  list(GET fields 3 data)
+  list(GET fields 4 const)
+  list(GET fields 5 bss)
+  list(GET fields 6 flash)
+  pad_right(c1 "${module}" 17)
+  pad_left(c2 "${data}" 8)
+  pad_left(c3 "${const}" 7)
+  pad_left(c4 "${bss}" 7)
+  pad_left(c5 "${ram}" 7)
+  pad_left(c6 "${flash}" 9)
+  message("${c1}${c2}${c3}${c4}${c5}${c6}")
+endforeach()
+
+math(EXPR total_ram "${total_data} + ${total_const} + ${total_bss}")
+pad_left(c2 "${total_data}" 8)
+pad_left(c3 "${total_const}" 7)
+pad_left(c4 "${total_bss}" 7)
+pad_left(c5 "${total_ram}" 7)
+pad_left(c6 "${total_flash}" 9)
+message("total            ${c2}${c3}${c4}${c5}${c6}")
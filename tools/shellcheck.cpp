@@ -0,0 +1,56 @@
+/************************************************************
+ *      CONFERÊNCIA DA LEITURA DE NÚMEROS (shell.h)         *
+ ************************************************************/
+//   shellcheck
+// Passa por shellParseFixed() entradas válidas, malformadas e no
+// limite de int32_t, contando as casas que faltam (a multiplicação
+// final também pode estourar). Devolve 1 na primeira diferença.
+#include <Arduino.h>
+#include <stdio.h>
+
+#include "../shell.h"
+
+struct Case {
+  const char* text;
+  uint8_t     decimals;
+  bool        ok;
+  int32_t     value;
+};
+
+static const Case cases[] = {
+  { "0",           0, true,  0 },
+  { "-12",         0, true,  -12 },
+  { "21.5",        2, true,  2150 },
+  { "21,57",       2, true,  2157 },
+  { "-0.5",        2, true,  -50 },
+  { "7.",          2, true,  700 },
+  { "2147483647",  0, true,  2147483647L },
+  { "-2147483647", 0, true,  -2147483647L },
+  { "21474836.47", 2, true,  2147483647L },
+  { "2147483648",  0, false, 0 },
+  { "21474836.48", 2, false, 0 },
+  { "99999999",    2, false, 0 },
+  { "21474837",    2, false, 0 },
+  { "9999999999",  0, false, 0 },
+  { "",            0, false, 0 },
+  { "-",           0, false, 0 },
+  { "1.234",       2, false, 0 },
+  { "1.2.3",       2, false, 0 },
+  { "12a",         0, false, 0 },
+};
+
+int main() {
+  unsigned count = sizeof(cases) / sizeof(cases[0]);
+  for (unsigned i = 0; i < count; i++) {
+    const Case& c = cases[i];
+    int32_t value = 0;
+    bool    ok    = shellParseFixed(c.text, c.decimals, value);
+    if (ok != c.ok || (ok && value != c.value)) {
+      printf("\"%s\" com %u casas: %s %ld, esperado %s %ld\n", c.text, c.decimals,
+             ok ? "aceito" : "recusado", (long)value, c.ok ? "aceito" : "recusado", (long)c.value);
+      return 1;
+    }
+  }
+  printf("%u entradas: shellParseFixed confere\n", count);
+  return 0;
+}
@@ -0,0 +1,105 @@
+/************************************************************
+ *      CONFERÊNCIA DA JANELA DE ESTATÍSTICAS (stats.h)     *
+ ************************************************************/
+//   statscheck [amostras] [semente]
+// Alimenta ChannelStats<int16_t> e ChannelStats<float> com valores
+// aleatórios em instantes com jitter (e alguns saltos maiores que a
+// janela) e, a cada amostra, compara contagem, média, mínimo, máximo
+// e variância com a conta direta sobre as amostras guardadas que
+// ainda caem na janela. Depois enche uma janela além de
+// STATS_MAX_SAMPLES. Devolve 1 na primeira diferença.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "../stats.h"
+
+#define WINDOW_MS  1000
+#define BUCKETS    5
+
+struct Sample {
+  uint32_t atMs;
+  int16_t  value;
+};
+
+static uint32_t rng = 1;
+
+static uint32_t next() {
+  rng = rng * 1103515245UL + 12345UL;
+  return rng >> 8;
+}
+
+// Amostras na janela: a fatia delas está entre as BUCKETS últimas,
+// contadas a partir da primeira amostra
+static void expected(const std::vector<Sample>& all, uint32_t nowMs, uint32_t& count,
+                     int64_t& sum, int64_t& sumSq, int16_t& lo, int16_t& hi) {
+  const uint32_t bucketMs = WINDOW_MS / BUCKETS;
+  uint32_t current = (nowMs - all[0].atMs) / bucketMs;
+  count = 0; sum = 0; sumSq = 0; lo = 0; hi = 0;
+  for (size_t i = 0; i < all.size(); i++) {
+    uint32_t slice = (all[i].atMs - all[0].atMs) / bucketMs;
+    if (slice + BUCKETS <= current) continue;
+    int16_t v = all[i].value;
+    if (count == 0 || v < lo) lo = v;
+    if (count == 0 || v > hi) hi = v;
+    count++;
+    sum   += v;
+    sumSq += (int64_t)v * v;
+  }
+}
+
+static int fail(unsigned long i, const char* what, double got, double want) {
+  printf("amostra %lu: %s = %g, esperado %g\n", i, what, got, want);
+  return 1;
+}
+
+int main(int argc, char** argv) {
+  unsigned long samples = argc > 1 ? strtoul(argv[1], NULL, 10) : 100000;
+  rng = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : 1;
+
+  ChannelStats<int16_t, BUCKETS> ints(WINDOW_MS);
+  ChannelStats<float, BUCKETS>   floats(WINDOW_MS);
+  std::vector<Sample> all;
+  uint32_t nowMs = 5000;
+
+  for (unsigned long i = 0; i < samples; i++) {
+    // 100 ms com jitter; de vez em quando um salto além da janela
+    nowMs += next() % 1000 == 0 ? 1000 + next() % 3000 : 60 + next() % 80;
+    Sample s;
+    s.atMs  = nowMs;
+    s.value = (int16_t)(next() % 20001) - 10000;
+    all.push_back(s);
+    ints.add(s.value, nowMs);
+    floats.add(s.value, nowMs);
+
+    uint32_t count;
+    int64_t  sum, sumSq;
+    int16_t  lo, hi;
+    expected(all, nowMs, count, sum, sumSq, lo, hi);
+    if (all.size() > 200) all.erase(all.begin() + 1, all.begin() + 101);
+
+    int64_t  n        = count;
+    int16_t  mean     = (int16_t)(sum >= 0 ? (sum + n / 2) / n : -((-sum + n / 2) / n));
+    int32_t  variance = n < 2 ? 0 : (int32_t)((n * sumSq - sum * sum) / (n * n));
+
+    if (ints.count() != count)        return fail(i, "count", ints.count(), count);
+    if (ints.mean() != mean)          return fail(i, "media", ints.mean(), mean);
+    if (ints.min() != lo)             return fail(i, "min", ints.min(), lo);
+    if (ints.max() != hi)             return fail(i, "max", ints.max(), hi);
+    if (ints.variance() != variance)  return fail(i, "variancia", ints.variance(), variance);
+    if (floats.count() != count)      return fail(i, "count (float)", floats.count(), count);
+    if (fabs(floats.mean() - (double)sum / n) > 0.01)
+      return fail(i, "media (float)", floats.mean(), (double)sum / n);
+  }
+  printf("%lu amostras: contagem, média, mínimo, máximo e variância conferem\n", samples);
+
+  // Janela cheia: o que passa de STATS_MAX_SAMPLES é ignorado inteiro
+  ChannelStats<int16_t, BUCKETS> full(WINDOW_MS);
+  for (uint32_t i = 0; i < STATS_MAX_SAMPLES; i++) full.add(32767, 100);
+  full.add(-32768, 100);
+  if (full.count() != STATS_MAX_SAMPLES || full.mean() != 32767 || full.min() != 32767)
+    return fail(STATS_MAX_SAMPLES, "janela cheia (media)", full.mean(), 32767);
+  printf("janela cheia: %u amostras, média %d, mínimo %d\n", full.count(), full.mean(), full.min());
+  return 0;
+}
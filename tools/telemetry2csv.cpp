@@ -0,0 +1,32 @@
+/************************************************************
+ *          TELEMETRIA BINÁRIA -> CSV (LINHA DE COMANDO)    *
+ ************************************************************/
+//   telemetry2csv [captura.bin] > dados.csv
+// Sem argumento, lê da entrada padrão (ex.: cat /dev/ttyACM0).
+#include <stdio.h>
+
+#include "telemetry_decoder.h"
+
+int main(int argc, char** argv) {
+  FILE* in = stdin;
+  if (argc > 1) {
+    in = fopen(argv[1], "rb");
+    if (!in) {
+      perror(argv[1]);
+      return 1;
+    }
+  }
+
+  TelemetryDecoder decoder(stdout);
+  decoder.writeHeader();
+
+  int c;
+  while ((c = fgetc(in)) != EOF) {
+    decoder.feed((uint8_t)c);
+  }
+
+  fprintf(stderr, "%lu quadros, %lu inválidos, %lu amostras perdidas\n",
+          decoder.frames(), decoder.badFrames(), decoder.lostSamples());
+  if (in != stdin) fclose(in);
+  return 0;
+}
@@ -0,0 +1,73 @@
+#include "telemetry_decoder.h"
+
+#include <time.h>
+
+// Valor de um canal de episódio: centésimos, exceto a luminosidade (%)
+static double channelValue(uint8_t channel, int16_t value) {
+  return channel == 2 ? value : value / 100.0;
+}
+
+static void formatTime(uint32_t timestamp, char* out, size_t size) {
+  time_t     t = (time_t)timestamp;
+  struct tm  parts;
+  gmtime_r(&t, &parts);            // o firmware já grava a hora local
+  strftime(out, size, "%Y-%m-%d %H:%M:%S", &parts);
+}
+
+TelemetryDecoder::TelemetryDecoder(FILE* csv)
+  : out(csv), lastSeq(-1),
+    frameCount(0), badCount(0), lostCount(0) {}
+
+void TelemetryDecoder::writeHeader() {
+  fprintf(out, "type,seq,timestamp,datetime,temp,temp_avg,humd,humd_avg,lum,ldr_raw,alerts,scale,"
+               "channel,minutes,min,max,mean\n");
+}
+
+void TelemetryDecoder::feed(uint8_t byte) {
+  size_t n = receiver.feed(byte);
+  if (n > 0) handleFrame(receiver.payload(), n);
+}
+
+void TelemetryDecoder::handleFrame(const uint8_t* raw, size_t n) {
+  char when[24];
+  TelemetrySample sample;
+  TelemetryRecord record;
+  TelemetryEpisode episode;
+
+  if (telemetryUnpackSample(raw, n, sample)) {
+    if (lastSeq >= 0) lostCount += (uint8_t)(sample.seq - lastSeq - 1);
+    lastSeq = sample.seq;
+
+    formatTime(sample.timestamp, when, sizeof(when));
+    fprintf(out, "sample,%u,%lu,%s,%.2f,%.2f,%.2f,%.2f,%d,%u,%u,%u,,,,,\n",
+            sample.seq, (unsigned long)sample.timestamp, when,
+            sample.temp / 100.0, sample.tempAvg / 100.0,
+            sample.humd / 100.0, sample.humdAvg / 100.0,
+            sample.lum, sample.ldrRaw, sample.flags & 0x0F,
+            (sample.flags >> TELEMETRY_SCALE_SHIFT) & 0x03);
+  }
+  else if (telemetryUnpackRecord(raw, n, record)) {
+    formatTime(record.timestamp, when, sizeof(when));
+    fprintf(out, "record,,%lu,%s,%.2f,,%.2f,,%d,,,,,,,,\n",
+            (unsigned long)record.timestamp, when,
+            record.temp / 100.0, record.humd / 100.0, record.lum);
+  }
+  else if (telemetryUnpackEpisode(raw, n, episode)) {
+    static const char* const events[] = { "episode", "episode_start", "episode_update", "episode_end" };
+    formatTime(episode.start, when, sizeof(when));
+    fprintf(out, "%s,,%lu,%s,,,,,,,,,%u,%u,%.2f,%.2f,%.2f\n",
+            events[episode.event <= 3 ? episode.event : 0],
+            (unsigned long)episode.start, when, episode.channel, episode.minutes,
+            channelValue(episode.channel, episode.min),
+            channelValue(episode.channel, episode.max),
+            channelValue(episode.channel, episode.mean));
+  }
+  else if (n > 0 && raw[0] >= TELEMETRY_DUMP_REQUEST && raw[0] <= TELEMETRY_DUMP_END) {
+    return;    // exportação do log: ver tools/logdump
+  }
+  else {
+    badCount++;
+    return;
+  }
+  frameCount++;
+}
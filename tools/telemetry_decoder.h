@@ -0,0 +1,37 @@
+/************************************************************
+ *        DECODIFICADOR DE TELEMETRIA BINÁRIA (HOST)        *
+ ************************************************************/
+// Recebe o fluxo da serial byte a byte, separa os quadros no
+// delimitador 0x00, confere o CRC e escreve cada quadro válido
+// como uma linha CSV. Bytes fora de quadro (texto do boot, ruído)
+// são descartados na ressincronização.
+#ifndef TELEMETRY_DECODER_H
+#define TELEMETRY_DECODER_H
+
+#include <stdio.h>
+
+#include "../telemetry.h"
+
+class TelemetryDecoder {
+public:
+  explicit TelemetryDecoder(FILE* csv);
+
+  void writeHeader();
+  void feed(uint8_t byte);
+
+  unsigned long frames() const    { return frameCount; }
+  unsigned long badFrames() const { return receiver.badFrames() + badCount; }
+  unsigned long lostSamples() const { return lostCount; }
+
+private:
+  void handleFrame(const uint8_t* raw, size_t n);
+
+  FILE*             out;
+  TelemetryReceiver receiver;
+  int               lastSeq;
+  unsigned long     frameCount;
+  unsigned long     badCount;       // quadros íntegros de tipo desconhecido
+  unsigned long     lostCount;
+};
+
+#endif